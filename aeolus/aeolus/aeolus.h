@@ -23,6 +23,7 @@
 
 struct MidiPatch;
 class Event;
+class PlayEvent;
 
 #include "stdint.h"
 #include "msynth/synti.h"
@@ -103,7 +104,7 @@ class Aeolus : public Synth {
       virtual QStringList soundFonts() const { return QStringList(); }
 
       virtual void process(unsigned, float*, float);
-      virtual void play(const Event&);
+      virtual void play(const PlayEvent&);
 
       virtual const QList<MidiPatch*>& getPatchInfo() const;
 
@@ -215,15 +215,13 @@ void Channel::pitchWheelSens(int val)
 
 //---------------------------------------------------------
 //   setPreset
+//    may be called from the audio thread; the samples of
+//    p are loaded by Fluid::loadPreset()
 //---------------------------------------------------------
 
 void Channel::setPreset(Preset* p)
       {
-      if (_preset != p) {
-            if (p)
-                  p->loadSamples();
-            _preset = p;
-            }
+      _preset = p;
       }
 
 }
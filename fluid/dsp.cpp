@@ -22,6 +22,10 @@
 #include "voice.h"
 #include "sfont.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace FluidS {
 
 /* Purpose:
@@ -60,6 +64,43 @@ float Voice::sinc_table7[FLUID_INTERP_MAX][7];
 
 #define SINC_INTERP_ORDER 7	/* 7th order constant */
 
+#ifdef __SSE2__
+//---------------------------------------------------------
+//   load4
+//    load four consecutive 16 bit sample points as float
+//---------------------------------------------------------
+
+static inline __m128 load4(const short* p)
+      {
+      __m128i v = _mm_loadl_epi64((const __m128i*)p);
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+      }
+
+//---------------------------------------------------------
+//   ampRamp
+//    amplitudes of four consecutive output samples
+//---------------------------------------------------------
+
+static inline __m128 ampRamp(float amp, float incr)
+      {
+      return _mm_add_ps(_mm_set1_ps(amp), _mm_mul_ps(_mm_set1_ps(incr), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+      }
+
+//---------------------------------------------------------
+//   phases4
+//    phases of four consecutive output samples
+//---------------------------------------------------------
+
+static inline void phases4(Phase* p, const Phase& phase, const Phase& incr)
+      {
+      p[0] = phase;
+      for (int k = 1; k < 4; ++k) {
+            p[k] = p[k-1];
+            p[k] += incr;
+            }
+      }
+#endif
+
 //---------------------------------------------------------
 //   dsp_float_config
 //    Initializes interpolation tables
@@ -142,6 +183,23 @@ int Voice::dsp_float_interpolate_none(unsigned n)
       while(1) {
             dsp_phase_index = dsp_phase.index_round();      // round to nearest point
 
+#ifdef __SSE2__
+            /* interpolate four sample points at a time */
+            for ( ; dsp_i + 4 <= n; dsp_i += 4) {
+                  Phase p[4];
+                  phases4(p, dsp_phase, dsp_phase_incr);
+                  if (p[3].index_round() > end_index)
+                        break;
+                  __m128 v = _mm_set_ps(dsp_data[p[3].index_round()], dsp_data[p[2].index_round()],
+                     dsp_data[p[1].index_round()], dsp_data[p[0].index_round()]);
+                  _mm_storeu_ps(dsp_buf + dsp_i, _mm_mul_ps(v, ampRamp(dsp_amp, dsp_amp_incr)));
+                  dsp_phase = p[3];
+                  dsp_phase += dsp_phase_incr;
+                  dsp_amp += 4 * dsp_amp_incr;
+                  }
+            dsp_phase_index = dsp_phase.index_round();
+#endif
+
             /* interpolate sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   dsp_buf[dsp_i] = dsp_amp * dsp_data[dsp_phase_index];
@@ -215,6 +273,32 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
       while (1) {
             dsp_phase_index = dsp_phase.index();
 
+#ifdef __SSE2__
+            /* interpolate four sample points at a time */
+            for ( ; dsp_i + 4 <= n; dsp_i += 4) {
+                  Phase p[4];
+                  phases4(p, dsp_phase, dsp_phase_incr);
+                  if ((unsigned)p[3].index() > end_index)
+                        break;
+                  const float* c[4];
+                  const short* d[4];
+                  for (int k = 0; k < 4; ++k) {
+                        c[k] = interp_coeff_linear[fluid_phase_fract_to_tablerow(p[k])];
+                        d[k] = dsp_data + p[k].index();
+                        }
+                  __m128 c0 = _mm_set_ps(c[3][0], c[2][0], c[1][0], c[0][0]);
+                  __m128 c1 = _mm_set_ps(c[3][1], c[2][1], c[1][1], c[0][1]);
+                  __m128 d0 = _mm_set_ps(d[3][0], d[2][0], d[1][0], d[0][0]);
+                  __m128 d1 = _mm_set_ps(d[3][1], d[2][1], d[1][1], d[0][1]);
+                  __m128 v  = _mm_add_ps(_mm_mul_ps(c0, d0), _mm_mul_ps(c1, d1));
+                  _mm_storeu_ps(dsp_buf + dsp_i, _mm_mul_ps(v, ampRamp(dsp_amp, dsp_amp_incr)));
+                  dsp_phase = p[3];
+                  dsp_phase += dsp_phase_incr;
+                  dsp_amp += 4 * dsp_amp_incr;
+                  }
+            dsp_phase_index = dsp_phase.index();
+#endif
+
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   coeffs = interp_coeff_linear[fluid_phase_fract_to_tablerow (dsp_phase)];
@@ -330,6 +414,30 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   amp += dsp_amp_incr;
                   }
 
+#ifdef __SSE2__
+            /* interpolate four sample points at a time: multiply the
+             * coefficient rows with the sample points and transpose the
+             * products to sum them up in parallel */
+            for ( ; dsp_i + 4 <= n; dsp_i += 4) {
+                  Phase p[4];
+                  phases4(p, phase, dsp_phase_incr);
+                  if ((unsigned)p[3].index() > end_index)
+                        break;
+                  __m128 s[4];
+                  for (int k = 0; k < 4; ++k) {
+                        const float* c = interp_coeff[fluid_phase_fract_to_tablerow(p[k])];
+                        s[k] = _mm_mul_ps(_mm_loadu_ps(c), load4(dsp_data + p[k].index() - 1));
+                        }
+                  _MM_TRANSPOSE4_PS(s[0], s[1], s[2], s[3]);
+                  __m128 v = _mm_add_ps(_mm_add_ps(s[0], s[1]), _mm_add_ps(s[2], s[3]));
+                  _mm_storeu_ps(dsp_buf + dsp_i, _mm_mul_ps(v, ampRamp(amp, dsp_amp_incr)));
+                  phase = p[3];
+                  phase += dsp_phase_incr;
+                  amp += 4 * dsp_amp_incr;
+                  }
+            dsp_phase_index = phase.index();
+#endif
+
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   coeffs = interp_coeff[fluid_phase_fract_to_tablerow (phase)];
@@ -528,6 +636,32 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
 
             start_index -= 2;	/* set back to original start index */
 
+#ifdef __SSE2__
+            /* interpolate four sample points at a time; the seven
+             * coefficients are split into 0-3 and 4-6 */
+            for ( ; dsp_i + 4 <= n && dsp_phase_index > start_index + 2; dsp_i += 4) {
+                  Phase p[4];
+                  phases4(p, dsp_phase, dsp_phase_incr);
+                  if ((unsigned)p[3].index() > end_index)
+                        break;
+                  __m128 s[4];
+                  for (int k = 0; k < 4; ++k) {
+                        const float* c = sinc_table7[fluid_phase_fract_to_tablerow(p[k])];
+                        const short* d = dsp_data + p[k].index();
+                        __m128 c2 = _mm_move_ss(_mm_loadu_ps(c + 3), _mm_setzero_ps());
+                        s[k] = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c), load4(d - 3)),
+                           _mm_mul_ps(c2, load4(d)));
+                        }
+                  _MM_TRANSPOSE4_PS(s[0], s[1], s[2], s[3]);
+                  __m128 v = _mm_add_ps(_mm_add_ps(s[0], s[1]), _mm_add_ps(s[2], s[3]));
+                  _mm_storeu_ps(dsp_buf + dsp_i, _mm_mul_ps(v, ampRamp(dsp_amp, dsp_amp_incr)));
+                  dsp_phase = p[3];
+                  dsp_phase += dsp_phase_incr;
+                  dsp_amp += 4 * dsp_amp_incr;
+                  dsp_phase_index = dsp_phase.index();
+                  }
+#endif
+
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   coeffs = sinc_table7[fluid_phase_fract_to_tablerow (dsp_phase)];
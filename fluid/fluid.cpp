@@ -36,6 +36,39 @@ namespace FluidS {
 
 bool Fluid::initialized = false;
 
+//---------------------------------------------------------
+//   VoiceWorker
+//    Renders voice partitions for Fluid::process().
+//    Worker idx renders partitions idx, idx + stride, ...
+//---------------------------------------------------------
+
+class VoiceWorker : public QThread {
+      Fluid* fluid;
+      int idx;
+      int stride;
+      QSemaphore go;
+      QSemaphore* done;
+      volatile bool quit;
+
+   protected:
+      virtual void run() {
+            for (;;) {
+                  go.acquire();
+                  if (quit)
+                        break;
+                  for (int p = idx; p < Fluid::PARTITIONS; p += stride)
+                        fluid->renderPartition(p);
+                  done->release();
+                  }
+            }
+
+   public:
+      VoiceWorker(Fluid* f, int i, int n, QSemaphore* d)
+         : fluid(f), idx(i), stride(n), done(d), quit(false) {}
+      void render()  { go.release(); }
+      void stop()    { quit = true; go.release(); wait(); }
+      };
+
 /* default modulators
  * SF2.01 page 52 ff:
  *
@@ -91,6 +124,12 @@ Fluid::Fluid()
       reverb    = 0;
       chorus    = 0;
       silentBlocks = 0;
+      fontSerial = 0;
+      playFonts = 0;
+      renderLen = 0;
+      rendering = false;
+      for (int i = 0; i < PARTITIONS; ++i)
+            partBuf[i] = new float[FLUID_MAX_BUFSIZE * 4];
       }
 
 //---------------------------------------------------------
@@ -131,6 +170,13 @@ void Fluid::init(int sr)
       reverb = new Reverb();
       chorus = new Chorus(sample_rate);
       reverb->setPreset(0);
+
+      int n = qMin(QThread::idealThreadCount(), int(PARTITIONS));
+      for (int i = 1; i < n; ++i) {
+            VoiceWorker* w = new VoiceWorker(this, i, n, &workDone);
+            workers.append(w);
+            w->start(QThread::TimeCriticalPriority);
+            }
       }
 
 //---------------------------------------------------------
@@ -140,12 +186,20 @@ void Fluid::init(int sr)
 Fluid::~Fluid()
       {
       _state = FLUID_SYNTH_STOPPED;
+      foreach(VoiceWorker* w, workers) {
+            w->stop();
+            delete w;
+            }
       foreach(Voice* v, activeVoices)
             delete v;
       foreach(Voice* v, freeVoices)
             delete v;
       foreach(SFont* sf, sfonts)
             delete sf;
+      for (int i = 0; i < removedFonts.size(); ++i)
+            delete removedFonts[i].second;
+      foreach(FontSet* fs, fontSets)
+            delete fs;
       foreach(BankOffset* bankOffset, bank_offsets)
             delete bankOffset;
       foreach(Channel* c, channel)
@@ -155,6 +209,8 @@ Fluid::~Fluid()
       delete[] right_buf;
       delete[] fx_buf[0];
       delete[] fx_buf[1];
+      for (int i = 0; i < PARTITIONS; ++i)
+            delete[] partBuf[i];
 
       delete reverb;
       delete chorus;
@@ -166,6 +222,8 @@ Fluid::~Fluid()
 
 void Fluid::freeVoice(Voice* v)
       {
+      if (rendering)          // renderParallel() frees the voice
+            return;
       if (activeVoices.removeOne(v))
             freeVoices.append(v);
       }
@@ -174,11 +232,13 @@ void Fluid::freeVoice(Voice* v)
 //   play
 //---------------------------------------------------------
 
-void Fluid::play(const Event& event)
+void Fluid::play(const PlayEvent& event)
       {
       bool err = false;
       int ch   = event.channel();
 
+      switchFonts();
+
       if (ch >= channel.size()) {
             for (int i = channel.size(); i < ch+1; i++)
                   channel.append(new Channel(this, i));
@@ -241,6 +301,118 @@ void Fluid::play(const Event& event)
                type, ch, qPrintable(error()));
       }
 
+//---------------------------------------------------------
+//   prepare
+//    load the preset of a program change before play()
+//    swaps it in on the audio thread
+//---------------------------------------------------------
+
+void Fluid::prepare(const PlayEvent& event)
+      {
+      if (event.type() != ME_CONTROLLER)
+            return;
+      int ch = event.channel();
+      switch(event.controller()) {
+            case CTRL_HBANK:
+                  loadBank[ch] = (event.value() & 0x7f) << 7;
+                  break;
+            case CTRL_LBANK:
+                  loadBank[ch] = (loadBank.value(ch) & ~0x7f) | (event.value() & 0x7f);
+                  break;
+            case CTRL_PROGRAM:
+                  {
+                  int bank = loadBank.value(ch);
+                  loadPrograms.insert(bank * 128 + event.value());
+                  loadPreset(find_preset(sfonts, bank, event.value()));
+                  }
+                  break;
+            }
+      }
+
+//---------------------------------------------------------
+//   loadPreset
+//    never called from the audio thread
+//---------------------------------------------------------
+
+void Fluid::loadPreset(Preset* p)
+      {
+      if (p && !p->loaded())
+            p->loadSamples();
+      }
+
+//---------------------------------------------------------
+//   loadChannelPresets
+//    load the presets of all prepare()d program changes
+//    and the default preset of new channels from the
+//    current sound fonts
+//---------------------------------------------------------
+
+void Fluid::loadChannelPresets()
+      {
+      foreach(int p, loadPrograms)
+            loadPreset(find_preset(sfonts, p / 128, p % 128));
+      loadPreset(find_preset(sfonts, 0, 0));
+      }
+
+//---------------------------------------------------------
+//   publishFonts
+//    hand the current sound fonts to the audio thread;
+//    sets and fonts it no longer plays are deleted
+//---------------------------------------------------------
+
+void Fluid::publishFonts(bool reset)
+      {
+      loadChannelPresets();
+      FontSet* fs = new FontSet;
+      fs->fonts   = sfonts;
+      fs->serial  = ++fontSerial;
+      fs->reset   = reset;
+      FontSet* pending = newFonts;
+      if (pending && pending->reset)
+            fs->reset = true;
+      fontSets.append(fs);
+      newFonts.fetchAndStoreOrdered(fs);
+
+      int acked = fontsAcked;
+      while (!fontSets.isEmpty() && fontSets.front()->serial < acked)
+            delete fontSets.takeFirst();
+      for (int i = 0; i < removedFonts.size();) {
+            if (removedFonts[i].first <= acked) {
+                  delete removedFonts[i].second;
+                  removedFonts.removeAt(i);
+                  }
+            else
+                  ++i;
+            }
+      }
+
+//---------------------------------------------------------
+//   switchFonts
+//    called by the audio thread before it plays; stops the
+//    voices of removed sound fonts and selects the presets
+//    of the published set
+//---------------------------------------------------------
+
+void Fluid::switchFonts()
+      {
+      FontSet* fs = newFonts.fetchAndStoreOrdered(0);
+      if (fs == 0)
+            return;
+      playFonts = fs;
+      for (int i = activeVoices.size() - 1; i >= 0; --i) {
+            Voice* v = activeVoices[i];
+            if (fs->reset || !fs->fonts.contains(v->sample->sf))
+                  v->off();
+            }
+      if (fs->reset) {
+            foreach(Channel* c, channel)
+                  c->reset();
+            }
+      else
+            program_reset();
+      fontsAcked.fetchAndStoreOrdered(fs->serial);
+      }
+
 //---------------------------------------------------------
 //   damp_voices
 //---------------------------------------------------------
@@ -372,9 +544,14 @@ Preset* Fluid::get_preset(char* sfont_name, unsigned banknum, unsigned prognum)
 //---------------------------------------------------------
 
 Preset* Fluid::find_preset(unsigned banknum, unsigned prognum)
+      {
+      return playFonts ? find_preset(playFonts->fonts, banknum, prognum) : 0;
+      }
+
+Preset* Fluid::find_preset(const QList<SFont*>& fl, unsigned banknum, unsigned prognum)
       {
       Preset* preset = 0;
-      foreach(SFont* sf, sfonts) {
+      foreach(SFont* sf, fl) {
             int offset = get_bank_offset(sf->id());
             preset = sf->get_preset(banknum - offset, prognum);
             if (preset)
@@ -493,19 +670,21 @@ void Fluid::process(unsigned len, float* out, float gain)
       memset(fx_buf[0], 0, byte_size);
       memset(fx_buf[1], 0, byte_size);
 
-      if (mutex.tryLock()) {
-            if (activeVoices.isEmpty())
-                  silentBlocks--;
-            else {
-                  silentBlocks = SILENT_BLOCKS;
+      switchFonts();
+      if (activeVoices.isEmpty())
+            silentBlocks--;
+      else {
+            silentBlocks = SILENT_BLOCKS;
+            if (workers.isEmpty() || activeVoices.size() < PARALLEL_VOICES) {
                   foreach (Voice* v, activeVoices)
                         v->write(len, left_buf, right_buf, fx_buf[0], fx_buf[1]);
                   }
-            if (silentBlocks > 0) {
-                  reverb->process(len, fx_buf[0], left_buf, right_buf);
-                  chorus->process(len, fx_buf[1], left_buf, right_buf);
-                  }
-            mutex.unlock();
+            else
+                  renderParallel(len);
+            }
+      if (silentBlocks > 0) {
+            reverb->process(len, fx_buf[0], left_buf, right_buf);
+            chorus->process(len, fx_buf[1], left_buf, right_buf);
             }
       for (unsigned i = 0; i < len; i++) {
             *out++ += gain * left_buf[i];
@@ -513,6 +692,69 @@ void Fluid::process(unsigned len, float* out, float gain)
             }
       }
 
+//---------------------------------------------------------
+//   renderParallel
+//    Render the active voices in PARTITIONS partitions
+//    using the worker threads. Voice i belongs to
+//    partition i % PARTITIONS and the partitions are
+//    mixed in fixed order, so the result does not depend
+//    on the number of threads.
+//---------------------------------------------------------
+
+void Fluid::renderParallel(unsigned len)
+      {
+      renderVoices = activeVoices;
+      renderLen    = len;
+      rendering    = true;
+      foreach(VoiceWorker* w, workers)
+            w->render();
+      int stride = workers.size() + 1;
+      for (int p = 0; p < PARTITIONS; p += stride)
+            renderPartition(p);
+      workDone.acquire(workers.size());
+      rendering = false;
+
+      for (int p = 0; p < PARTITIONS; ++p) {
+            const float* l   = partBuf[p];
+            const float* r   = l + FLUID_MAX_BUFSIZE;
+            const float* rev = r + FLUID_MAX_BUFSIZE;
+            const float* cho = rev + FLUID_MAX_BUFSIZE;
+            for (unsigned i = 0; i < len; ++i) {
+                  left_buf[i]  += l[i];
+                  right_buf[i] += r[i];
+                  fx_buf[0][i] += rev[i];
+                  fx_buf[1][i] += cho[i];
+                  }
+            }
+
+      // free the voices which ended while rendering
+      foreach(Voice* v, renderVoices) {
+            if (v->status == FLUID_VOICE_OFF)
+                  freeVoice(v);
+            }
+      renderVoices.clear();
+      }
+
+//---------------------------------------------------------
+//   renderPartition
+//    called from the audio thread and the workers
+//---------------------------------------------------------
+
+void Fluid::renderPartition(int partition)
+      {
+      float* l   = partBuf[partition];
+      float* r   = l + FLUID_MAX_BUFSIZE;
+      float* rev = r + FLUID_MAX_BUFSIZE;
+      float* cho = rev + FLUID_MAX_BUFSIZE;
+      memset(l,   0, renderLen * sizeof(float));
+      memset(r,   0, renderLen * sizeof(float));
+      memset(rev, 0, renderLen * sizeof(float));
+      memset(cho, 0, renderLen * sizeof(float));
+      int n = renderVoices.size();
+      for (int i = partition; i < n; i += PARTITIONS)
+            renderVoices.at(i)->write(renderLen, l, r, rev, cho);
+      }
+
 /*
  * fluid_synth_free_voice_by_kill
  *
@@ -713,20 +955,15 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
             // printf("Fluid:loadSoundFonts: already loaded\n");
             return true;
             }
-      mutex.lock();
-      foreach(Voice* v, activeVoices)
-            v->off();
-      foreach(Channel* c, channel)
-            c->reset();
       foreach (SFont* sf, sfonts)
-            sfunload(sf->id(), true);
+            sfunload(sf->id());
       bool ok = true;
 
       for (int i = sl.size() - 1; i >= 0; --i) {
-            if (sfload(sl[i], true) == -1)
+            if (sfload(sl[i]) == -1)
                   ok = false;
             }
-      mutex.unlock();
+      publishFonts(true);
       return ok;
       }
 
@@ -737,9 +974,8 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
 
 bool Fluid::addSoundFont(const QString& s)
       {
-      mutex.lock();
-      bool rv = (sfload(s, true) == -1) ? false : true;
-      mutex.unlock();
+      bool rv = (sfload(s) == -1) ? false : true;
+      publishFonts(false);
       return rv;
       }
 
@@ -750,20 +986,21 @@ bool Fluid::addSoundFont(const QString& s)
 
 bool Fluid::removeSoundFont(const QString& s)
       {
-      mutex.lock();
-      foreach(Voice* v, activeVoices)
-            v->off();
       SFont* sf = get_sfont_by_name(s);
-      sfunload(sf->id(), true);
-      mutex.unlock();
+      if (sf == 0)
+            return false;
+      sfunload(sf->id());
+      publishFonts(false);
       return true;
       }
 
 //---------------------------------------------------------
 //   sfload
+//    read a sound font; it is played after the next
+//    publishFonts()
 //---------------------------------------------------------
 
-int Fluid::sfload(const QString& filename, bool reset_presets)
+int Fluid::sfload(const QString& filename)
       {
       if (filename.isEmpty())
             return -1;
@@ -780,19 +1017,17 @@ int Fluid::sfload(const QString& filename, bool reset_presets)
       /* insert the sfont as the first one on the list */
       sfonts.prepend(sf);
 
-      /* reset the presets for all channels */
-      if (reset_presets)
-            program_reset();
-
       updatePatchList();
       return sf->id();
       }
 
 //---------------------------------------------------------
 //   sfunload
+//    the sound font is deleted when the audio thread no
+//    longer plays it
 //---------------------------------------------------------
 
-bool Fluid::sfunload(int id, bool reset_presets)
+bool Fluid::sfunload(int id)
       {
       SFont* sf = get_sfont_by_id(id);
 
@@ -802,13 +1037,7 @@ bool Fluid::sfunload(int id, bool reset_presets)
             }
 
       sfonts.removeAll(sf);   // remove the SoundFont from the list
-
-      /* reset the presets for all channels */
-      if (reset_presets)
-            program_reset();
-      else
-            update_presets();
-      delete sf;
+      removedFonts.append(qMakePair(fontSerial + 1, sf));
       updatePatchList();
       return true;
       }
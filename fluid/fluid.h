@@ -39,6 +39,7 @@ class Chorus;
 class Fluid;
 
 #define FLUID_MAX_BUFSIZE       4096
+#define FLUID_BUFSIZE           64          // block size of the voice filter
 #define FLUID_NUM_PROGRAMS      129
 
 enum fluid_loop {
@@ -309,15 +310,42 @@ enum {
       CHORUS_GAIN
       };
 
+//---------------------------------------------------------
+//   FontSet
+//    the sound fonts the audio thread plays; published by
+//    the gui thread and never changed afterwards
+//---------------------------------------------------------
+
+struct FontSet {
+      QList<SFont*> fonts;
+      int serial;
+      bool reset;             // reset all channels on switching to the set
+      };
+
 //---------------------------------------------------------
 //   Fluid
 //---------------------------------------------------------
 
+class VoiceWorker;
+
 class Fluid : public Synth {
       static const int SILENT_BLOCKS = 32*5;
       int silentBlocks;
 
-      QList<SFont*> sfonts;               // the loaded soundfonts
+   public:
+      static const int PARTITIONS      = 4;   // voice partitions which can be rendered in parallel
+      static const int PARALLEL_VOICES = 16;  // min. number of active voices for parallel rendering
+
+   private:
+
+      QList<SFont*> sfonts;               // the loaded soundfonts, gui thread
+      QList<FontSet*> fontSets;           // published sets, oldest first
+      QList<QPair<int, SFont*> > removedFonts;  // deleted once the audio thread
+                                          // switched to the set of the serial
+      int fontSerial;                     // serial of the last published set
+      QAtomicPointer<FontSet> newFonts;   // set the audio thread switches to
+      QAtomicInt fontsAcked;              // serial of the set the audio thread plays
+      FontSet* playFonts;                 // audio thread
       QList<BankOffset*> bank_offsets;    // the offsets of the soundfont banks
       QList<MidiPatch*> patches;
 
@@ -332,8 +360,23 @@ class Fluid : public Synth {
       float _masterTuning;                // usually 440.0
       double _tuning[128];                // the pitch of every key, in cents
 
-      QMutex mutex;
       void updatePatchList();
+      void publishFonts(bool reset);
+      void switchFonts();
+
+      QMap<int, int> loadBank;            // bank of prepare()d program changes per channel
+      QSet<int> loadPrograms;             // bank * 128 + program of prepare()d presets
+      void loadPreset(Preset*);
+      void loadChannelPresets();
+
+      QList<VoiceWorker*> workers;        // render threads, the audio thread is the first worker
+      QSemaphore workDone;
+      QList<Voice*> renderVoices;         // voices rendered by renderParallel()
+      unsigned renderLen;
+      bool rendering;                     // true while renderParallel() is running
+      float* partBuf[PARTITIONS];         // left, right, reverb and chorus mix of a partition
+
+      void renderParallel(unsigned len);
 
    protected:
       int _state;                         // the synthesizer state
@@ -357,8 +400,8 @@ class Fluid : public Synth {
       SFont* get_sfont(int idx) const     { return sfonts[idx];   }
       void remove_sfont(SFont* sf);
       int add_sfont(SFont* sf);
-      bool sfunload(int id, bool reset_presets);
-      int sfload(const QString& filename, bool reset_presets);
+      bool sfunload(int id);
+      int sfload(const QString& filename);
 
    public:
       Fluid();
@@ -367,7 +410,8 @@ class Fluid : public Synth {
 
       virtual const char* name() const { return "Fluid"; }
 
-      virtual void play(const Event&);
+      virtual void play(const PlayEvent&);
+      virtual void prepare(const PlayEvent&);
       virtual const QList<MidiPatch*>& getPatchInfo() const { return patches; }
 
       // set/get a single parameter
@@ -384,6 +428,7 @@ class Fluid : public Synth {
 
       Preset* get_preset(unsigned int sfontnum, unsigned int banknum, unsigned int prognum);
       Preset* find_preset(unsigned int banknum, unsigned int prognum);
+      Preset* find_preset(const QList<SFont*>&, unsigned int banknum, unsigned int prognum);
       void modulate_voices(int chan, bool is_cc, int ctrl);
       void modulate_voices_all(int chan);
       void damp_voices(int chan);
@@ -437,6 +482,7 @@ class Fluid : public Synth {
       void get_pitch_bend(int chan, int* ppitch_bend);
 
       void freeVoice(Voice* v);
+      void renderPartition(int partition);
 
       double getPitch(int k) const   { return _tuning[k]; }
       float ct2hz_real(float cents)  { return powf(2.0f, (cents - 6900.0f) / 1200.0f) * _masterTuning; }
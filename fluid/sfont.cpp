@@ -49,9 +49,11 @@ SFVersion::SFVersion()
 
 SFont::SFont(Fluid* f)
       {
-      synth      = f;
-      samplepos  = 0;
-      samplesize = 0;
+      synth       = f;
+      samplepos   = 0;
+      samplesize  = 0;
+      sampleData  = 0;
+      mapFailed   = false;
       }
 
 SFont::~SFont()
@@ -91,6 +93,43 @@ bool SFont::read(const QString& s)
       return true;
       }
 
+//---------------------------------------------------------
+//   mapSamples
+//    map the sample chunk of the sound font file once;
+//    samples are paged in by the os when they are played
+//---------------------------------------------------------
+
+const uchar* SFont::mapSamples()
+      {
+      if (sampleData || mapFailed)
+            return sampleData;
+      sampleFile.setFileName(f.fileName());
+      if (sampleFile.open(QIODevice::ReadOnly))
+            sampleData = sampleFile.map(samplepos, samplesize);
+      if (sampleData == 0) {
+            qWarning("fluid: cannot map sample data of <%s>", qPrintable(sampleFile.fileName()));
+            sampleFile.close();
+            mapFailed = true;
+            }
+#ifdef SOUNDFONT3
+      else if (_version.major == 3) {
+            // decoded samples are cached on disk, keyed by a hash
+            // of the sound font path, size and modification time
+            QFileInfo fi(sampleFile);
+            QCryptographicHash h(QCryptographicHash::Md5);
+            h.addData(fi.absoluteFilePath().toUtf8());
+            h.addData(QByteArray::number(fi.size()));
+            h.addData(fi.lastModified().toString(Qt::ISODate).toAscii());
+            QString path = QString("%1/sf3/%2")
+               .arg(QDesktopServices::storageLocation(QDesktopServices::CacheLocation))
+               .arg(QString(h.result().toHex()));
+            if (QDir().mkpath(path))
+                  _decodeCache = path;
+            }
+#endif
+      return sampleData;
+      }
+
 //---------------------------------------------------------
 //   get_preset
 //---------------------------------------------------------
@@ -114,6 +153,7 @@ Preset::Preset(SFont* s)
       bank         = 0;
       num          = 0;
       _global_zone = 0;
+      _loaded      = false;
       }
 
 //---------------------------------------------------------
@@ -127,31 +167,70 @@ Preset::~Preset()
             delete z;
       }
 
+#ifdef SOUNDFONT3
+//---------------------------------------------------------
+//   decodeSample
+//---------------------------------------------------------
+
+static void decodeSample(Sample*& s)
+      {
+      s->decode();
+      }
+#endif
+
 //---------------------------------------------------------
 //   loadSamples
-//    this is called if the preset is associated with a
-//    channel
+//    called by Fluid::loadPreset() outside of the audio
+//    thread; compressed samples are decoded in parallel
+//    and stay decoded while the sound font is loaded
 //---------------------------------------------------------
 
 void Preset::loadSamples()
       {
-//      sfont->synth->mutex.lock();
-      if (_global_zone && _global_zone->instrument) {
-            Instrument* i = _global_zone->instrument;
-            if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
-            foreach(Zone* iz, i->zones)
-                  iz->sample->load();
+      if (_loaded)
+            return;
+      _loaded = true;
+      QList<Sample*> sl;
+      if (_global_zone && _global_zone->instrument)
+            instrumentSamples(_global_zone->instrument, &sl);
+      foreach(Zone* z, zones)
+            instrumentSamples(z->instrument, &sl);
+
+      QList<Sample*> packed;
+      foreach(Sample* s, sl) {
+            if (s->data || !s->valid())
+                  continue;
+            if (s->sampletype & FLUID_SAMPLETYPE_OGG_VORBIS)
+                  packed.append(s);
+            else
+                  s->load();
+            }
+#ifdef SOUNDFONT3
+      if (packed.isEmpty() || !sfont->mapSamples())
+            return;
+      QtConcurrent::blockingMap(packed, decodeSample);
+      foreach(Sample* s, packed) {
+            if (s->data)
+                  s->optimize();
             }
+#endif
+      }
 
-      foreach(Zone* z, zones) {
-            Instrument* i = z->instrument;
-            if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
-            foreach(Zone* iz, i->zones)
-                  iz->sample->load();
+//---------------------------------------------------------
+//   instrumentSamples
+//    add all samples of instrument i to sl
+//---------------------------------------------------------
+
+void Preset::instrumentSamples(Instrument* i, QList<Sample*>* sl) const
+      {
+      if (i == 0)
+            return;
+      if (i->global_zone && i->global_zone->sample && !sl->contains(i->global_zone->sample))
+            sl->append(i->global_zone->sample);
+      foreach(Zone* iz, i->zones) {
+            if (iz->sample && !sl->contains(iz->sample))
+                  sl->append(iz->sample);
             }
-//      sfont->synth->mutex.unlock();
       }
 
 //---------------------------------------------------------
@@ -183,6 +262,10 @@ bool Preset::noteon(Fluid* synth, unsigned id, int chan, int key, int vel, doubl
                         /* check if the note falls into the key and velocity range of this
                            instrument */
                         if (inst_zone->inside_range(key, vel) && (sample != 0)) {
+                              // the preset was not loaded by Fluid::loadPreset();
+                              // never decode in the audio thread
+                              if (sample->data == 0)
+                                    continue;
 
                               /* this is a good zone. allocate a new synthesis process and
                                  initialize it */
@@ -583,7 +666,10 @@ Sample::Sample(SFont* s)
       origpitch   = 0;
       pitchadj    = 0;
       sampletype  = 0;
+      packedStart = 0;
+      packedSize  = 0;
       data        = 0;
+      _ownsData   = true;
       amplitude_that_reaches_noise_floor_is_valid = false;
       amplitude_that_reaches_noise_floor = 0.0;
       }
@@ -594,7 +680,8 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
+      if (_ownsData)
+            delete[] data;
       }
 
 //---------------------------------------------------------
@@ -605,55 +692,39 @@ void Sample::load()
       {
       if (!_valid || data)
             return;
-      QFile fd(sf->get_name());
-      if (!fd.open(QIODevice::ReadOnly))
+      const uchar* p = sf->mapSamples();
+      if (p == 0)
             return;
-      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
-            if (!fd.seek(sf->samplePos() + start))
-                  return;
-            }
-      else {
-            if (!fd.seek(sf->samplePos() + start * sizeof(short)))
-                  return;
-            }
-      unsigned int size = end - start;
 
       if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
 #ifdef SOUNDFONT3
-            char* p = new char[size];
-            if (fd.read(p, size) != size) {
-                  printf("  read %d failed\n", size);
-                  return;
-                  }
-            decompressOggVorbis(p, size);
-            delete[] p;
+            if (decode() && data)
+                  _ownsData = true;
 #endif
             }
       else {
-            data = new short[size];
-            size *= sizeof(short);
-
-            if (fd.read((char*)data, size) != size)
-                  return;
-
-            if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-                  unsigned char hi, lo;
-                  unsigned int i, j;
-                  short s;
-                  uchar* cbuf = (uchar*) data;
-                  for (i = 0, j = 0; j < size; i++) {
-                        lo = cbuf[j++];
-                        hi = cbuf[j++];
-                        s = (hi << 8) | lo;
-                        data[i] = s;
-                        }
+            unsigned int size = end - start;
+            const short* src  = (const short*)(p + start * sizeof(short));
+
+            if (QSysInfo::ByteOrder == QSysInfo::LittleEndian && !(quintptr(src) & 1)) {
+                  // use sample data in place
+                  data      = const_cast<short*>(src);
+                  _ownsData = false;
+                  }
+            else {
+                  data      = new short[size];
+                  _ownsData = true;
+                  const uchar* cbuf = (const uchar*)src;
+                  for (unsigned int i = 0, j = 0; i < size; i++, j += 2)
+                        data[i] = short((cbuf[j+1] << 8) | cbuf[j]);
                   }
             end       -= (start + 1);       // marks last sample, contrary to SF spec.
             loopstart -= start;
             loopend   -= start;
             start      = 0;
             }
-      optimize();
+      if (data)
+            optimize();
       }
 
 //---------------------------------------------------------
@@ -1615,6 +1686,8 @@ void SFont::load_shdr (int size)
                   }
             p->setValid(true);
             if (p->sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
+                  p->packedStart = p->start;
+                  p->packedSize  = p->end - p->start;
                   }
             else {
                   // loop is fowled?? (cluck cluck :)
@@ -54,6 +54,11 @@ class SFont {
       QFile f;
       unsigned samplepos;           // the position in the file at which the sample data starts
       unsigned samplesize;          // the size of the sample data
+      QFile sampleFile;             // stays open while the sample data is mapped
+      uchar* sampleData;            // mapped sample chunk
+      bool mapFailed;
+
+      QString _decodeCache;         // directory of decoded sf3 samples
 
       QList<Instrument*> instruments;
       QList<Preset*> presets;
@@ -113,6 +118,8 @@ class SFont {
       void setSamplepos(unsigned v)             { samplepos = v; }
       void setSamplesize(unsigned v)            { samplesize = v; }
       unsigned getSamplesize() const            { return samplesize; }
+      const uchar* mapSamples();
+      const QString& decodeCache() const        { return _decodeCache; }
       const QList<Preset*> getPresets() const   { return presets; }
       SFVersion version() const                 { return _version; }
       friend class Preset;
@@ -124,6 +131,7 @@ class SFont {
 
 class Sample {
       bool _valid;
+      bool _ownsData;         // false if data points into the mapped file
 
    public:
       SFont* sf;
@@ -135,6 +143,8 @@ class Sample {
       int origpitch;
       int pitchadj;
       int sampletype;
+      unsigned int packedStart;     // byte range of compressed sample data
+      unsigned int packedSize;
 
       short* data;
 
@@ -152,10 +162,13 @@ class Sample {
       bool inRom() const;
       void optimize();
       void load();
+      unsigned int dataSize() const { return (end + 1) * sizeof(short); }
       bool valid() const    { return _valid; }
       void setValid(bool v) { _valid = v; }
 #ifdef SOUNDFONT3
+      bool decode();
       bool decompressOggVorbis(char* p, int size);
+      short* decodeOggVorbis(const char* p, int size, int* n);
 #endif
       };
 
@@ -218,6 +231,9 @@ class Preset {
 
       Zone* _global_zone;           // the global zone of the preset
       QList<Zone*> zones;
+      bool _loaded;                 // samples are loaded
+
+      void instrumentSamples(Instrument*, QList<Sample*>*) const;
 
    public:
       Preset(SFont* sfont);
@@ -233,6 +249,7 @@ class Preset {
 
       Zone* global_zone()                       { return _global_zone; }
       void loadSamples();
+      bool loaded() const                       { return _loaded; }
       QList<Zone*> getZones()                   { return zones; }
       };
 
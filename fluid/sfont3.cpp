@@ -6,38 +6,186 @@
 
 namespace FluidS {
 
+//---------------------------------------------------------
+//   PcmBuffer
+//    destination of the decoder; sized from the granule
+//    position of the last ogg page, grows if the stream
+//    is longer
+//---------------------------------------------------------
+
+struct PcmBuffer {
+      short* data;
+      int size;
+      int capacity;
+
+      PcmBuffer(int n) {
+            capacity = qMax(n, 1024);
+            data     = new short[capacity];
+            size     = 0;
+            }
+      ~PcmBuffer() { delete[] data; }
+      void reserve(int n) {
+            if (size + n <= capacity)
+                  return;
+            capacity = qMax(capacity * 2, size + n);
+            short* p = new short[capacity];
+            memcpy(p, data, size * sizeof(short));
+            delete[] data;
+            data = p;
+            }
+      short* take() {
+            short* p = data;
+            data = 0;
+            return p;
+            }
+      };
+
+//---------------------------------------------------------
+//   oggLength
+//    number of samples in an ogg vorbis stream taken from
+//    the granule position of its last page
+//---------------------------------------------------------
+
+static int oggLength(const char* src, int size)
+      {
+      for (int i = size - 27; i >= 0; --i) {
+            if (src[i] == 'O' && src[i+1] == 'g' && src[i+2] == 'g' && src[i+3] == 'S') {
+                  qint64 granule = 0;
+                  for (int k = 7; k >= 0; --k)
+                        granule = (granule << 8) | (uchar)src[i + 6 + k];
+                  return (granule > 0 && granule < (1 << 28)) ? int(granule) : 0;
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   cacheFile
+//---------------------------------------------------------
+
+static QString cacheFile(const Sample* s)
+      {
+      const QString& path = s->sf->decodeCache();
+      if (path.isEmpty())
+            return QString();
+      return QString("%1/%2.pcm").arg(path).arg(s->packedStart);
+      }
+
+//---------------------------------------------------------
+//   readCache
+//    read decoded sample data from the disk cache
+//---------------------------------------------------------
+
+static short* readCache(const Sample* s, int* n)
+      {
+      QString path = cacheFile(s);
+      if (path.isEmpty())
+            return 0;
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly))
+            return 0;
+      qint64 bytes = f.size();
+      if (bytes < qint64(8 * sizeof(short)) || bytes >= (1 << 29))
+            return 0;
+      short* p = new short[bytes / sizeof(short)];
+      if (f.read((char*)p, bytes) != bytes) {
+            delete[] p;
+            return 0;
+            }
+      *n = bytes / sizeof(short);
+      return p;
+      }
+
+//---------------------------------------------------------
+//   writeCache
+//    the file is written under a temporary name and
+//    renamed, a partially written file is never read
+//---------------------------------------------------------
+
+static void writeCache(const Sample* s, const short* p, int n)
+      {
+      QString path = cacheFile(s);
+      if (path.isEmpty())
+            return;
+      QString tmp = path + QString(".%1").arg(quintptr(s));
+      QFile f(tmp);
+      if (!f.open(QIODevice::WriteOnly))
+            return;
+      qint64 bytes = n * sizeof(short);
+      bool ok = f.write((const char*)p, bytes) == bytes;
+      f.close();
+      if (!ok || !QFile::rename(tmp, path))
+            QFile::remove(tmp);
+      }
+
+//---------------------------------------------------------
+//   decode
+//    decode sample data from the mapped sound font;
+//    can be called concurrently for different samples
+//---------------------------------------------------------
+
+bool Sample::decode()
+      {
+      const uchar* p = sf->mapSamples();
+      if (p == 0)
+            return false;
+      return decompressOggVorbis((char*)p + packedStart, packedSize);
+      }
+
 //---------------------------------------------------------
 //   decompressOggVorbis
 //---------------------------------------------------------
 
 bool Sample::decompressOggVorbis(char* src, int size)
       {
-#define MAX_OUT   1024*500
-      short odata[MAX_OUT];
-      short* oPtr = odata;
-
-      ogg_sync_state   oy; // sync and verify incoming physical bitstream
-      ogg_stream_state os; // take physical pages, weld into a logical stream of packets
-      ogg_page         og; // one Ogg bitstream page. Vorbis packets are inside
-      ogg_packet       op; // one raw packet of data for decode
-      vorbis_info      vi; // struct that stores all the static vorbis bitstream settings
-      vorbis_comment   vc; // struct that stores all the bitstream user comments
+      int n;
+      short* p = readCache(this, &n);
+      if (p == 0) {
+            p = decodeOggVorbis(src, size, &n);
+            if (p == 0)
+                  return false;
+            writeCache(this, p, n);
+            }
+      data  = p;
+      start = 0;
+      end   = n;
 
-      ogg_sync_init(&oy); // Now we can read pages
+      if (loopend > end ||loopstart >= loopend || loopstart <= start) {
+            /* can pad loop by 8 samples and ensure at least 4 for loop (2*8+4) */
+            if ((end - start) >= 20) {
+                  loopstart = start + 8;
+                  loopend   = end - 8;
+                  }
+            else {      // loop is fowled, sample is tiny (can't pad 8 samples)
+                  loopstart = start + 1;
+                  loopend   = end - 1;
+                  }
+            }
+      if ((end - start) < 8) {
+            printf("invalid sample\n");
+            setValid(false);
+            }
+      end -= 1;
 
-      bool eos = false;
+// printf("  vorbis sample 0-%d %d %d\n", end, loopstart, loopend);
+      return true;
+      }
 
-      /* grab some data at the head of the stream. We want the first page
-         (which is guaranteed to be small and only contain the Vorbis
-         stream initial header) We need the first page to get the stream
-         serialno. */
+//---------------------------------------------------------
+//   readOggHeaders
+//    set up the logical stream from the first page and
+//    read the three vorbis headers; *streamInit tells
+//    whether os has to be cleared by the caller
+//---------------------------------------------------------
 
-      char* buffer = ogg_sync_buffer(&oy, size);
-      memcpy(buffer, src, size);
-      ogg_sync_wrote(&oy, size);
+static bool readOggHeaders(ogg_sync_state* oy, ogg_stream_state* os, bool* streamInit,
+   vorbis_info* vi, vorbis_comment* vc)
+      {
+      ogg_page   og;
+      ogg_packet op;
 
       /* Get the first page. */
-      if (ogg_sync_pageout(&oy, &og) != 1) {
+      if (ogg_sync_pageout(oy, &og) != 1) {
             /* error case.  Must not be Vorbis data */
             fprintf(stderr,"Input does not appear to be an Ogg bitstream.\n");
             return false;
@@ -45,7 +193,8 @@ bool Sample::decompressOggVorbis(char* src, int size)
 
       /* Get the serial number and set up the rest of decode. */
       /* serialno first; use it to set up a logical stream */
-      ogg_stream_init(&os, ogg_page_serialno(&og));
+      ogg_stream_init(os, ogg_page_serialno(&og));
+      *streamInit = true;
 
       /* extract the initial header from the first page and verify that the
          Ogg bitstream is in fact Vorbis data */
@@ -55,21 +204,19 @@ bool Sample::decompressOggVorbis(char* src, int size)
          header is an easy way to identify a Vorbis bitstream and it's
          useful to see that functionality seperated out. */
 
-      vorbis_info_init(&vi);
-      vorbis_comment_init(&vc);
-      if (ogg_stream_pagein(&os,&og) < 0) {
+      if (ogg_stream_pagein(os, &og) < 0) {
             /* error; stream version mismatch perhaps */
             fprintf(stderr,"Error reading first page of Ogg bitstream data.\n");
             return false;
             }
 
-      if (ogg_stream_packetout(&os,&op) != 1) {
+      if (ogg_stream_packetout(os, &op) != 1) {
             /* no page? must not be vorbis */
             fprintf(stderr,"Error reading initial header packet.\n");
             return false;
             }
 
-      if (vorbis_synthesis_headerin(&vi, &vc, &op) < 0) {
+      if (vorbis_synthesis_headerin(vi, vc, &op) < 0) {
             /* error case; not a vorbis header */
             fprintf(stderr,"This Ogg bitstream does not contain Vorbis "
                "audio data.\n");
@@ -88,56 +235,73 @@ bool Sample::decompressOggVorbis(char* src, int size)
 
       int i = 0;
       while (i < 2) {
-            while (i < 2) {
-                  int result = ogg_sync_pageout(&oy, &og);
-                  if (result == 0)
-                        break; /* Need more data */
-                  /* Don't complain about missing or corrupt data yet. We'll
-                    catch it at the packet output phase */
-                  if (result == 1) {
-                        ogg_stream_pagein(&os, &og);
-                        while (i < 2) {
-                              result = ogg_stream_packetout(&os, &op);
-                              if (result == 0)
-                                    break;
-                              if (result < 0) {
-                                    /* Uh oh; data at some point was corrupted or missing!
-                                       We can't tolerate that in a header.  Die. */
-                                    fprintf(stderr,"Corrupt secondary header.  Exiting.\n");
-                                    return false;
-                                    }
-                              if (vorbis_synthesis_headerin(&vi,&vc,&op) < 0) {
-                                    fprintf(stderr,"Corrupt secondary header.  Exiting.\n");
-                                    return false;
-                                    }
-                              i++;
+            int result = ogg_sync_pageout(oy, &og);
+            if (result == 0) {
+                  /* all data is in the sync buffer */
+                  fprintf(stderr,"Missing secondary header.\n");
+                  return false;
+                  }
+            /* Don't complain about missing or corrupt data yet. We'll
+              catch it at the packet output phase */
+            if (result == 1) {
+                  ogg_stream_pagein(os, &og);
+                  while (i < 2) {
+                        result = ogg_stream_packetout(os, &op);
+                        if (result == 0)
+                              break;
+                        if (result < 0) {
+                              /* Uh oh; data at some point was corrupted or missing!
+                                 We can't tolerate that in a header.  Die. */
+                              fprintf(stderr,"Corrupt secondary header.  Exiting.\n");
+                              return false;
                               }
+                        if (vorbis_synthesis_headerin(vi, vc, &op) < 0) {
+                              fprintf(stderr,"Corrupt secondary header.  Exiting.\n");
+                              return false;
+                              }
+                        i++;
                         }
                   }
             }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   decodeOggPackets
+//    decode all audio packets of the stream into out
+//---------------------------------------------------------
+
+static void decodeOggPackets(ogg_sync_state* oy, ogg_stream_state* os, vorbis_info* vi,
+   PcmBuffer* out)
+      {
+      ogg_page   og;
+      ogg_packet op;
+      bool eos = false;
 
       /* OK, got and parsed all three headers. Initialize the Vorbis
          packet->PCM decoder. */
       vorbis_dsp_state vd;    // central working state for the packet->PCM decoder
 
-      if (vorbis_synthesis_init(&vd, &vi) == 0) { /* central decode state */
+      if (vorbis_synthesis_init(&vd, vi) == 0) { /* central decode state */
             vorbis_block vb; // local working space for packet->PCM decode
             vorbis_block_init(&vd, &vb);
 
             /* The rest is just a straight decode loop until end of stream */
-            while(!eos) {
-                  while(!eos) {
-                        int result = ogg_sync_pageout(&oy, &og);
-                        if (result == 0)
-                              break; /* need more data */
+            while (!eos) {
+                  while (!eos) {
+                        int result = ogg_sync_pageout(oy, &og);
+                        if (result == 0) {
+                              eos = true; /* no more data */
+                              break;
+                              }
                         if (result<0) { /* missing or corrupt data at this page position */
                               fprintf(stderr,"Corrupt or missing data in bitstream; "
                                  "continuing...\n");
                               }
                         else {
-                              ogg_stream_pagein(&os, &og);
+                              ogg_stream_pagein(os, &og);
                               while (1) {
-                                    result = ogg_stream_packetout(&os, &op);
+                                    result = ogg_stream_packetout(os, &op);
                                     if (result == 0)
                                           break; /* need more data */
                                     if (result<0) { /* missing or corrupt data at this page position */
@@ -152,6 +316,8 @@ bool Sample::decompressOggVorbis(char* src, int size)
                                                 vorbis_synthesis_blockin(&vd, &vb);
 
                                           while ((samples = vorbis_synthesis_pcmout(&vd, &pcm)) > 0) {
+                                                out->reserve(samples);
+                                                short* oPtr = out->data + out->size;
                                                 for (int j = 0; j < samples; j++) {
                                                       int val = floor(pcm[0][j] * 32767.f + .5f);
                                                       /* might as well guard against clipping */
@@ -160,9 +326,8 @@ bool Sample::decompressOggVorbis(char* src, int size)
                                                       if (val < -32768)
                                                             val = -32768;
                                                       *oPtr++ = val;
-                                                      if ((oPtr - odata) >= MAX_OUT)
-                                                            abort();
                                                       }
+                                                out->size += samples;
                                                 vorbis_synthesis_read(&vd, samples);
                                                 }
                                           }
@@ -181,36 +346,48 @@ bool Sample::decompressOggVorbis(char* src, int size)
       else{
             fprintf(stderr,"Error: Corrupt header during playback initialization.\n");
             }
+      }
 
-      ogg_stream_clear(&os);
-      vorbis_comment_clear(&vc);
-      vorbis_info_clear(&vi);
-      ogg_sync_clear(&oy);
+//---------------------------------------------------------
+//   decodeOggVorbis
+//    return decoded data and its length in n
+//---------------------------------------------------------
 
-      start = 0;
-      end   = oPtr - odata;
+short* Sample::decodeOggVorbis(const char* src, int size, int* n)
+      {
+      ogg_sync_state   oy; // sync and verify incoming physical bitstream
+      ogg_stream_state os; // take physical pages, weld into a logical stream of packets
+      vorbis_info      vi; // struct that stores all the static vorbis bitstream settings
+      vorbis_comment   vc; // struct that stores all the bitstream user comments
 
-      if (loopend > end ||loopstart >= loopend || loopstart <= start) {
-            /* can pad loop by 8 samples and ensure at least 4 for loop (2*8+4) */
-            if ((end - start) >= 20) {
-                  loopstart = start + 8;
-                  loopend   = end - 8;
-                  }
-            else {      // loop is fowled, sample is tiny (can't pad 8 samples)
-                  loopstart = start + 1;
-                  loopend   = end - 1;
-                  }
-            }
-      if ((end - start) < 8) {
-            printf("invalid sample\n");
-            setValid(false);
-            }
+      ogg_sync_init(&oy); // Now we can read pages
+      vorbis_info_init(&vi);
+      vorbis_comment_init(&vc);
 
-      data = new short[end];
-      memcpy(data, odata, end * sizeof(short));
-      end -= 1;
+      bool streamInit = false;
+      PcmBuffer out(oggLength(src, size));
 
-// printf("  vorbis sample 0-%d %d %d\n", end, loopstart, loopend);
-      return true;
+      /* grab some data at the head of the stream. We want the first page
+         (which is guaranteed to be small and only contain the Vorbis
+         stream initial header) We need the first page to get the stream
+         serialno. */
+
+      char* buffer = ogg_sync_buffer(&oy, size);
+      memcpy(buffer, src, size);
+      ogg_sync_wrote(&oy, size);
+
+      if (readOggHeaders(&oy, &os, &streamInit, &vi, &vc))
+            decodeOggPackets(&oy, &os, &vi, &out);
+
+      if (streamInit)
+            ogg_stream_clear(&os);
+      vorbis_comment_clear(&vc);
+      vorbis_info_clear(&vi);
+      ogg_sync_clear(&oy);
+
+      if (out.size == 0)
+            return 0;
+      *n = out.size;
+      return out.take();
       }
 } // namespace
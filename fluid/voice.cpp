@@ -24,6 +24,10 @@
 #include "gen.h"
 #include "voice.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace FluidS {
 
 #define FLUID_SAMPLESANITY_CHECK (1 << 0)
@@ -500,7 +504,7 @@ void Voice::write(unsigned n, float* left, float* right, float* reverb, float* c
                          * at will.
                          */
 
-                  #define FILTER_TRANSITION_SAMPLES 64     // (FLUID_BUFSIZE)
+                  #define FILTER_TRANSITION_SAMPLES FLUID_BUFSIZE
 
                         a1_incr = (a1_temp - a1) / FILTER_TRANSITION_SAMPLES;
                         a2_incr = (a2_temp - a2) / FILTER_TRANSITION_SAMPLES;
@@ -1679,6 +1683,47 @@ void Sample::optimize()
  * - dsp_hist2: same
  *
  */
+//---------------------------------------------------------
+//   mix
+//    dst += gain * src
+//---------------------------------------------------------
+
+static void mix(float* dst, const float* src, float gain, int n)
+      {
+      int i = 0;
+#ifdef __SSE2__
+      __m128 g = _mm_set1_ps(gain);
+      for (; i + 4 <= n; i += 4)
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(g, _mm_loadu_ps(src + i))));
+#endif
+      for (; i < n; ++i)
+            dst[i] += gain * src[i];
+      }
+
+//---------------------------------------------------------
+//   mix2
+//    dst1 += gain1 * src, dst2 += gain2 * src
+//---------------------------------------------------------
+
+static void mix2(float* dst1, float* dst2, const float* src, float gain1, float gain2, int n)
+      {
+      int i = 0;
+#ifdef __SSE2__
+      __m128 g1 = _mm_set1_ps(gain1);
+      __m128 g2 = _mm_set1_ps(gain2);
+      for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(src + i);
+            _mm_storeu_ps(dst1 + i, _mm_add_ps(_mm_loadu_ps(dst1 + i), _mm_mul_ps(g1, v)));
+            _mm_storeu_ps(dst2 + i, _mm_add_ps(_mm_loadu_ps(dst2 + i), _mm_mul_ps(g2, v)));
+            }
+#endif
+      for (; i < n; ++i) {
+            float v = src[i];
+            dst1[i] += gain1 * v;
+            dst2[i] += gain2 * v;
+            }
+      }
+
 void Voice::effects(int count, float* left, float* right, float* reverb, float* chorus)
       {
       /* filter (implement the voice filter according to SoundFont standard) */
@@ -1710,11 +1755,31 @@ void Voice::effects(int count, float* left, float* right, float* reverb, float*
                   }
             }
       else { /* The filter parameters are constant.  This is duplicated to save time. */
-            for (int i = 0; i < count; i++) {   // The filter is implemented in Direct-II form.
-                  float dsp_centernode = dsp_buf[i] - a1 * hist1 - a2 * hist2;
-                  dsp_buf[i]     = b02 * (dsp_centernode + hist2) + b1 * hist1;
-                  hist2          = hist1;
-                  hist1          = dsp_centernode;
+            /* Only the recursive part of the Direct-II form has to be
+             * computed sample by sample. The center nodes of a block
+             * are stored in w[] (w[0], w[1] is the history), the
+             * output is then computed four samples at a time. */
+            float w[FLUID_BUFSIZE + 2];
+            for (int k = 0; k < count; k += FLUID_BUFSIZE) {
+                  float* buf = dsp_buf + k;
+                  int n = qMin(count - k, FLUID_BUFSIZE);
+                  w[0] = hist2;
+                  w[1] = hist1;
+                  for (int i = 0; i < n; i++)
+                        w[i + 2] = buf[i] - a1 * w[i + 1] - a2 * w[i];
+                  int i = 0;
+#ifdef __SSE2__
+                  __m128 vb02 = _mm_set1_ps(b02);
+                  __m128 vb1  = _mm_set1_ps(b1);
+                  for (; i + 4 <= n; i += 4) {
+                        __m128 v = _mm_mul_ps(vb02, _mm_add_ps(_mm_loadu_ps(w + i + 2), _mm_loadu_ps(w + i)));
+                        _mm_storeu_ps(buf + i, _mm_add_ps(v, _mm_mul_ps(vb1, _mm_loadu_ps(w + i + 1))));
+                        }
+#endif
+                  for (; i < n; i++)
+                        buf[i] = b02 * (w[i + 2] + w[i]) + b1 * w[i + 1];
+                  hist2 = w[n];
+                  hist1 = w[n + 1];
                   }
             }
 
@@ -1725,29 +1790,16 @@ void Voice::effects(int count, float* left, float* right, float* reverb, float*
        */
       if ((-0.5 < pan) && (pan < 0.5)) {
             /* The voice is centered. Use amp_left twice. */
-            for (int i = 0; i < count; i++) {
-                  float v = amp_left * dsp_buf[i];
-                  left[i]  += v;
-                  right[i] += v;
-                  }
+            mix2(left, right, dsp_buf, amp_left, amp_left, count);
             }
       else {     /* The voice is not centered. Stereo samples have one side zero. */
-            if (amp_left != 0.0) {
-                  for (int i = 0; i < count; i++)
-                        left[i] += amp_left * dsp_buf[i];
-                  }
-
-            if (amp_right != 0.0) {
-                  for (int i = 0; i < count; i++)
-                        right[i] += amp_right * dsp_buf[i];
-                  }
+            if (amp_left != 0.0)
+                  mix(left, dsp_buf, amp_left, count);
+            if (amp_right != 0.0)
+                  mix(right, dsp_buf, amp_right, count);
             }
 
-      for (int i = 0; i < count; i++) {
-            float v = dsp_buf[i];
-            reverb[i] += amp_reverb * v;
-            chorus[i] += amp_chorus * v;
-            }
+      mix2(reverb, chorus, dsp_buf, amp_reverb, amp_chorus, count);
       }
 
 }
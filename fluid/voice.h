@@ -24,6 +24,8 @@
 #include "fluid.h"
 #include "gen.h"
 
+class TestDsp;
+
 namespace FluidS {
 
 #define NO_CHANNEL             0xff
@@ -72,6 +74,8 @@ class Voice
 
       void effects(int count, float* left, float* right, float* reverb, float* chorus);
 
+      friend class ::TestDsp;
+
    public:
 	unsigned int id;                // the id is incremented for every new noteon.
 					        // it's used for noteoff's
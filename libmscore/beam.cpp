@@ -1092,10 +1092,15 @@ static void initBeamMetrics()
 
 static Bm beamMetric1(bool up, char l1, char l2)
       {
-      static int initialized = false;
+      // part scores are laid out concurrently
+      static QAtomicInt initialized(0);
       if (!initialized) {
-            initBeamMetrics();
-            initialized = true;
+            static QMutex mutex;
+            QMutexLocker locker(&mutex);
+            if (!initialized) {
+                  initBeamMetrics();
+                  initialized = 1;
+                  }
             }
       return bMetrics[Bm::key(up, l1, l2)];
       }
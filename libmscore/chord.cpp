@@ -825,9 +825,9 @@ void Chord::readNote(XmlReader& e)
 void Chord::read(XmlReader& e)
       {
       while (e.readNextStartElement()) {
-            const QStringRef& tag(e.name());
+            const XmlTag tag = e.tag();
 
-            if (tag == "Note") {
+            if (tag == TAG_Note) {
                   Note* note = new Note(score());
                   // the note needs to know the properties of the track it belongs to
                   note->setTrack(track());
@@ -835,27 +835,27 @@ void Chord::read(XmlReader& e)
                   note->read(e);
                   add(note);
                   }
-            else if (tag == "appoggiatura") {
+            else if (tag == TAG_appoggiatura) {
                   _noteType = NOTE_APPOGGIATURA;
                   e.readNext();
                   }
-            else if (tag == "acciaccatura") {
+            else if (tag == TAG_acciaccatura) {
                   _noteType = NOTE_ACCIACCATURA;
                   e.readNext();
                   }
-            else if (tag == "grace4") {
+            else if (tag == TAG_grace4) {
                   _noteType = NOTE_GRACE4;
                   e.readNext();
                   }
-            else if (tag == "grace16") {
+            else if (tag == TAG_grace16) {
                   _noteType = NOTE_GRACE16;
                   e.readNext();
                   }
-            else if (tag == "grace32") {
+            else if (tag == TAG_grace32) {
                   _noteType = NOTE_GRACE32;
                   e.readNext();
                   }
-            else if (tag == "StemDirection") {
+            else if (tag == TAG_StemDirection) {
                   QString val(e.readElementText());
                   if (val == "up")
                         _stemDirection = MScore::UP;
@@ -864,39 +864,39 @@ void Chord::read(XmlReader& e)
                   else
                         _stemDirection = MScore::Direction(val.toInt());
                   }
-            else if (tag == "noStem")
+            else if (tag == TAG_noStem)
                   _noStem = e.readInt();
-            else if (tag == "Arpeggio") {
+            else if (tag == TAG_Arpeggio) {
                   _arpeggio = new Arpeggio(score());
                   _arpeggio->setTrack(track());
                   _arpeggio->read(e);
                   _arpeggio->setParent(this);
                   }
-            else if (tag == "Glissando") {
+            else if (tag == TAG_Glissando) {
                   _glissando = new Glissando(score());
                   _glissando->setTrack(track());
                   _glissando->read(e);
                   _glissando->setParent(this);
                   }
-            else if (tag == "Tremolo") {
+            else if (tag == TAG_Tremolo) {
                   _tremolo = new Tremolo(score());
                   _tremolo->setTrack(track());
                   _tremolo->read(e);
                   _tremolo->setParent(this);
                   }
-            else if (tag == "tickOffset")       // obsolete
+            else if (tag == TAG_tickOffset)     // obsolete
                   ;
-            else if (tag == "Stem") {
+            else if (tag == TAG_Stem) {
                   _stem = new Stem(score());
                   _stem->read(e);
                   add(_stem);
                   }
-            else if (tag == "Hook") {
+            else if (tag == TAG_Hook) {
                   _hook = new Hook(score());
                   _hook->read(e);
                   add(_hook);
                   }
-            else if (tag == "ChordLine") {
+            else if (tag == TAG_ChordLine) {
                   ChordLine* cl = new ChordLine(score());
                   cl->read(e);
                   add(cl);
@@ -1809,15 +1809,15 @@ bool Chord::setProperty(P_ID propertyId, const QVariant& v)
       switch(propertyId) {
             case P_NO_STEM:
                   setNoStem(v.toBool());
-                  score()->setLayoutAll(true);
+                  score()->setLayout(measure());
                   break;
             case P_SMALL:
                   setSmall(v.toBool());
-                  score()->setLayoutAll(true);
+                  score()->setLayout(measure());
                   break;
             case P_STEM_DIRECTION:
                   setStemDirection(MScore::Direction(v.toInt()));
-                  score()->setLayoutAll(true);
+                  score()->setLayout(measure());
                   break;
             default:
                   return ChordRest::setProperty(propertyId, v);
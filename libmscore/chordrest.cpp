@@ -225,9 +225,9 @@ bool ChordRest::readProperties(XmlReader& e)
       {
       if (DurationElement::readProperties(e))
             return true;
-      const QStringRef& tag(e.name());
+      const XmlTag tag = e.tag();
 
-      if (tag == "BeamMode") {
+      if (tag == TAG_BeamMode) {
             QString val(e.readElementText());
             int bm = BEAM_AUTO;
             if (val == "auto")
@@ -248,18 +248,18 @@ bool ChordRest::readProperties(XmlReader& e)
                   bm = BeamMode(val.toInt());
             _beamMode = BeamMode(bm);
             }
-      else if (tag == "Attribute" || tag == "Articulation") {     // obsolete: "Attribute"
+      else if (tag == TAG_Attribute || tag == TAG_Articulation) {     // obsolete: "Attribute"
             Articulation* atr = new Articulation(score());
             atr->read(e);
             add(atr);
             }
-      else if (tag == "leadingSpace") {
+      else if (tag == TAG_leadingSpace) {
             qDebug("ChordRest: leadingSpace obsolete"); // _extraLeadingSpace = Spatium(val.toDouble());
             }
-      else if (tag == "trailingSpace") {
+      else if (tag == TAG_trailingSpace) {
             qDebug("ChordRest: trailingSpace obsolete"); // _extraTrailingSpace = Spatium(val.toDouble());
             }
-      else if (tag == "Beam") {
+      else if (tag == TAG_Beam) {
             int id = e.readInt();
             Beam* beam = e.findBeam(id);
             if (beam)
@@ -267,9 +267,9 @@ bool ChordRest::readProperties(XmlReader& e)
             else
                   qDebug("Beam id %d not found", id);
             }
-      else if (tag == "small")
+      else if (tag == TAG_small)
             _small = e.readInt();
-      else if (tag == "Slur") {
+      else if (tag == TAG_Slur) {
             int id = e.intAttribute("number");
             QString type(e.attribute("type"));
             Slur* slur = static_cast<Slur*>(e.findSpanner(id));
@@ -290,7 +290,7 @@ bool ChordRest::readProperties(XmlReader& e)
                   }
             e.readNext();
             }
-      else if (tag == "durationType") {
+      else if (tag == TAG_durationType) {
             setDurationType(e.readElementText());
             if (durationType().type() != TDuration::V_MEASURE) {
                   if ((type() == REST) &&
@@ -317,9 +317,9 @@ bool ChordRest::readProperties(XmlReader& e)
                         }
                   }
             }
-      else if (tag == "duration")
+      else if (tag == TAG_duration)
             setDuration(e.readFraction());
-      else if (tag == "ticklen") {      // obsolete (version < 1.12)
+      else if (tag == TAG_ticklen) {      // obsolete (version < 1.12)
             int mticks = score()->sigmap()->timesig(e.tick()).timesig().ticks();
             int i = e.readInt();
             if (i == 0)
@@ -335,12 +335,12 @@ bool ChordRest::readProperties(XmlReader& e)
                   setDurationType(TDuration(f));
                   }
             }
-      else if (tag == "dots")
+      else if (tag == TAG_dots)
             setDots(e.readInt());
-      else if (tag == "move")
+      else if (tag == TAG_move)
             _staffMove = e.readInt();
-      else if (tag == "Lyrics" /*|| tag == "FiguredBass"*/) {
-            Element* element = Element::name2Element(tag, score());
+      else if (tag == TAG_Lyrics /*|| tag == TAG_FiguredBass*/) {
+            Element* element = Element::name2Element(e.name(), score());
             element->setTrack(e.track());
             element->read(e);
             add(element);
@@ -97,6 +97,29 @@ void Score::startCmd()
       undo(new SaveState(this));
       }
 
+//---------------------------------------------------------
+//   layoutScore
+//---------------------------------------------------------
+
+static void layoutScore(Score* score)
+      {
+      score->end2();
+      }
+
+//---------------------------------------------------------
+//   undoRedoLayout
+//---------------------------------------------------------
+
+static void undoRedoLayout(Score* score)
+      {
+      if (score->layoutAll()) {
+            score->setUndoRedo(true);
+            score->doLayout();
+            score->setUndoRedo(false);
+            score->setUpdateAll(true);
+            }
+      }
+
 //---------------------------------------------------------
 //   endCmd
 ///   End a GUI command by (if \a undo) ending a user-visble undo
@@ -112,8 +135,17 @@ void Score::endCmd()
             return;
             }
 
-      foreach(Score* s, scoreList())
-            s->end2();
+      bool changed = undo()->current()->childCount() > 1;
+      if (changed) {
+            foreach(Score* s, scoreList()) {
+                  // invalidate cached midi events of changed measures
+                  if (s->_layoutAll || s->startLayout == 0)
+                        s->setPlaybackDirty();
+                  else
+                        s->setPlaybackDirty(s->startLayout);
+                  }
+            }
+      layoutScores(layoutScore);
 
       bool noUndo = undo()->current()->childCount() <= 1;
       if (!noUndo)
@@ -140,10 +172,116 @@ void Score::end()
 
 void Score::update()
       {
-      foreach(Score* s, scoreList()) {
-            s->end2();
+      layoutScores(layoutScore);
+      foreach(Score* s, scoreList())
             s->end1();
+      }
+
+//---------------------------------------------------------
+//   PartLayout
+//    a part score laid out in a worker thread and the
+//    undo commands its layout pushed
+//---------------------------------------------------------
+
+struct PartLayout {
+      Score* score;
+      QList<UndoCommand*> commands;
+
+      PartLayout(Score* s = 0) : score(s) {}
+      };
+
+//---------------------------------------------------------
+//   LayoutPart
+//---------------------------------------------------------
+
+struct LayoutPart {
+      typedef void result_type;
+      void (*layout)(Score*);
+
+      LayoutPart(void (*l)(Score*)) : layout(l) {}
+      void operator()(PartLayout& pl) const {
+            pl.score->undo()->beginDeferred();
+            layout(pl.score);
+            pl.commands = pl.score->undo()->takeDeferred();
             }
+      };
+
+//---------------------------------------------------------
+//   layoutScores
+//    Lay out the root score, then all part scores
+//    concurrently. Parts share only read only data with
+//    each other. Undo commands pushed by the layout of a
+//    part are collected and appended in score order, and
+//    viewers are told about the new layout from this
+//    thread. A part nobody is looking at is laid out when
+//    it is shown or exported (doDeferredLayout()).
+//---------------------------------------------------------
+
+void Score::layoutScores(void (*layout)(Score*))
+      {
+      QList<Score*> scores = scoreList();
+      layout(scores.takeFirst());
+
+      QList<PartLayout> parts;
+      foreach(Score* s, scores) {
+            if (!s->viewer.isEmpty())
+                  parts.append(PartLayout(s));
+            else if (s->_layoutAll || s->startLayout) {
+                  s->_layoutAll      = true;
+                  s->startLayout     = 0;
+                  s->_layoutDeferred = true;
+                  }
+            }
+      if (parts.size() == 1)
+            layout(parts.front().score);
+      else if (!parts.isEmpty()) {
+            QtConcurrent::blockingMap(parts, LayoutPart(layout));
+            foreach(const PartLayout& pl, parts) {
+                  undo()->appendDeferred(pl.commands);
+                  pl.score->flushViewers();
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   doDeferredLayout
+//    catch up on the layout of a part score which was
+//    skipped while it had no view
+//---------------------------------------------------------
+
+void Score::doDeferredLayout()
+      {
+      if (_layoutDeferred)
+            end2();
+      }
+
+//---------------------------------------------------------
+//   notifyViewers
+//    Tell the viewers that the layout changed. Viewers
+//    are widgets; a score laid out in a worker thread
+//    only remembers the change, flushViewers() must be
+//    called from the gui thread afterwards.
+//---------------------------------------------------------
+
+void Score::notifyViewers()
+      {
+      if (QThread::currentThread() != thread()) {
+            _viewersPending = true;
+            return;
+            }
+      _viewersPending = false;
+      foreach(MuseScoreView* v, viewer)
+            v->layoutChanged();
+      }
+
+//---------------------------------------------------------
+//   flushViewers
+//---------------------------------------------------------
+
+void Score::flushViewers()
+      {
+      if (_viewersPending)
+            notifyViewers();
       }
 
 //---------------------------------------------------------
@@ -162,10 +300,14 @@ void Score::end2()
             _updateAll = true;
             _needLayout = true;
             }
-      if (_needLayout)
-            doLayout();
-      _layoutAll   = false;
-      startLayout = 0;
+      if (_needLayout) {
+            // try to relayout only the system of "startLayout"
+            if (startLayout == 0 || !doReLayout())
+                  doLayout();
+            }
+      _layoutAll      = false;
+      _layoutDeferred = false;
+      startLayout     = 0;
       }
 
 //---------------------------------------------------------
@@ -174,9 +316,16 @@ void Score::end2()
 
 void Score::end1()
       {
+      // tempo changes take effect on playback times here,
+      // lookups by the sequencer never rebuild the table
+      if (this == rootScore() && !repeatList()->timeTableValid())
+            repeatList()->update();
       if (_updateAll) {
-            foreach(MuseScoreView* v, viewer)
+            foreach(MuseScoreView* v, viewer) {
+                  if (!refresh.isNull())
+                        v->dataChanged(refresh);
                   v->updateAll();
+                  }
             }
       else {
             // update a little more:
@@ -197,15 +346,9 @@ void Score::end1()
 void Score::endUndoRedo()
       {
       updateSelection();
-      foreach(Score* score, scoreList()) {
-            if (score->layoutAll()) {
-                  score->setUndoRedo(true);
-                  score->doLayout();
-                  score->setUndoRedo(false);
-                  score->setUpdateAll(true);
-                  }
-            score->setPlaylistDirty(true);
-            }
+      layoutScores(undoRedoLayout);
+      foreach(Score* score, scoreList())
+            score->setPlaybackDirty();
       end();
       }
 
@@ -1095,6 +1238,9 @@ void Score::upDown(bool up, UpDownMode mode)
             }
       if (el.empty())
             return;
+      // ChangePitch asks for a layout of the changed measures,
+      // notes within one system only need a relayout of it
+      setLayoutAll(false);
 
       foreach(Note* oNote, el) {
             Part* part  = oNote->staff()->part();
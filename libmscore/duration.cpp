@@ -91,8 +91,8 @@ bool DurationElement::readProperties(XmlReader& e)
       {
       if (Element::readProperties(e))
             return true;
-      const QStringRef& tag(e.name());
-      if (tag == "Tuplet") {
+      const XmlTag tag = e.tag();
+      if (tag == TAG_Tuplet) {
             // setTuplet(0);
             int i = e.readInt();
             Tuplet* t = e.findTuplet(i);
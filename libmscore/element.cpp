@@ -653,17 +653,17 @@ void Element::writeProperties(Xml& xml) const
 
 bool Element::readProperties(XmlReader& e)
       {
-      const QStringRef& tag(e.name());
+      const XmlTag tag = e.tag();
 
-      if (tag == "color")
+      if (tag == TAG_color)
             _color = e.readColor();
-      else if (tag == "visible")
+      else if (tag == TAG_visible)
             _visible = e.readInt();
-      else if (tag == "selected")
+      else if (tag == TAG_selected)
             _selected = e.readInt();
-      else if (tag == "userOff")
+      else if (tag == TAG_userOff)
             _userOff = e.readPoint();
-      else if (tag == "lid") {
+      else if (tag == TAG_lid) {
             int id = e.readInt();
             _links = score()->links().value(id);
             if (!_links) {
@@ -684,24 +684,24 @@ bool Element::readProperties(XmlReader& e)
 #endif
             _links->append(this);
             }
-      else if (tag == "tick") {
+      else if (tag == TAG_tick) {
             int val = e.readInt();
             if (type() != SYMBOL)   // hack for 1.2
                   e.setTick(score()->fileDivision(val));
             }
-      else if (tag == "offset") {         // ??obsolete -> used for volta
+      else if (tag == TAG_offset) {         // ??obsolete -> used for volta
             qreal _spatium = spatium();
             QPointF pt(e.readPoint() * _spatium);
             setUserOff(pt);
             // _readPos = QPointF();
             }
-      else if (tag == "pos")
+      else if (tag == TAG_pos)
             _readPos = e.readPoint() * spatium();
-      else if (tag == "voice")
+      else if (tag == TAG_voice)
             setTrack((_track/VOICES)*VOICES + e.readInt());
-      else if (tag == "track")
+      else if (tag == TAG_track)
             setTrack(e.readInt());
-      else if (tag == "tag") {
+      else if (tag == TAG_tag) {
             QString val(e.readElementText());
             for (int i = 1; i < MAX_TAGS; i++) {
                   if (score()->layerTags()[i] == val) {
@@ -710,7 +710,7 @@ bool Element::readProperties(XmlReader& e)
                         }
                   }
             }
-      else if (tag == "placement")
+      else if (tag == TAG_placement)
             _placement = Placement(::getProperty(P_PLACEMENT, e).toInt());
       else
             return false;
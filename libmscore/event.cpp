@@ -17,6 +17,7 @@
 #include "part.h"
 #include "event.h"
 #include "event_p.h"
+#include <algorithm>
 
 //---------------------------------------------------------
 //   Event::Event
@@ -356,3 +357,90 @@ QString midiMetaName(int meta)
             }
       return QString(s);
       }
+
+//---------------------------------------------------------
+//   PlayEvent
+//---------------------------------------------------------
+
+PlayEvent::PlayEvent(const Event& e, int tick)
+      {
+      _tick    = tick;
+      _type    = e.type();
+      _channel = e.channel();
+      _a       = e.dataA();
+      _b       = e.dataB();
+      _tuning  = e.tuning();
+      _note    = e.note();
+      }
+
+//---------------------------------------------------------
+//   isChannelEvent
+//---------------------------------------------------------
+
+bool PlayEvent::isChannelEvent() const
+      {
+      switch(_type) {
+            case ME_NOTEOFF:
+            case ME_NOTEON:
+            case ME_POLYAFTER:
+            case ME_CONTROLLER:
+            case ME_PROGRAM:
+            case ME_AFTERTOUCH:
+            case ME_PITCHBEND:
+            case ME_NOTE:
+            case ME_CHORD:
+                  return true;
+            default:
+                  return false;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   playEventLessThan
+//---------------------------------------------------------
+
+static bool playEventLessThan(const PlayEvent& e1, const PlayEvent& e2)
+      {
+      return e1.tick() < e2.tick();
+      }
+
+//---------------------------------------------------------
+//   add
+//    append a list of events shifted by tickOffset
+//---------------------------------------------------------
+
+void EventMap::add(const QVector<PlayEvent>& el, int tickOffset)
+      {
+      foreach(PlayEvent e, el) {
+            e.setTick(e.tick() + tickOffset);
+            _events.append(e);
+            }
+      }
+
+//---------------------------------------------------------
+//   sort
+//    sort the events appended since the last call and
+//    merge them into the already sorted events
+//---------------------------------------------------------
+
+void EventMap::sort()
+      {
+      QVector<PlayEvent>::iterator b = _events.begin();
+      QVector<PlayEvent>::iterator m = b + _sorted;
+      QVector<PlayEvent>::iterator e = _events.end();
+      std::stable_sort(m, e, playEventLessThan);
+      std::inplace_merge(b, m, e, playEventLessThan);
+      _sorted = _events.size();
+      }
+
+//---------------------------------------------------------
+//   lowerBound
+//    return first event at tick or later
+//---------------------------------------------------------
+
+EventMap::const_iterator EventMap::lowerBound(int tick) const
+      {
+      return std::lower_bound(_events.constBegin(), _events.constEnd(), PlayEvent(tick, 0, 0, 0, 0),
+         playEventLessThan);
+      }
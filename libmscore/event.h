@@ -188,9 +188,49 @@ class Event {
       void setTuning(qreal v);
       };
 
+//---------------------------------------------------------
+//   PlayEvent
+//    compact, trivially copyable midi channel event
+//    used for playback; no reference counting and no
+//    allocation
+//---------------------------------------------------------
+
+class PlayEvent {
+      int _tick;              // unrolled tick
+      short _type;
+      short _channel;
+      int _a;                 // pitch or controller
+      int _b;                 // velocity or controller value
+      float _tuning;
+      const Note* _note;      // note this event was rendered from
+
+   public:
+      PlayEvent() {}
+      PlayEvent(int tick, int type, int channel, int a, int b, float tuning = 0.0, const Note* note = 0)
+         : _tick(tick), _type(type), _channel(channel), _a(a), _b(b), _tuning(tuning), _note(note) {}
+      PlayEvent(const Event&, int tick = 0);
+
+      bool isChannelEvent() const;
+
+      int tick() const              { return _tick;    }
+      void setTick(int v)           { _tick = v;       }
+      int type() const              { return _type;    }
+      int channel() const           { return _channel; }
+      int dataA() const             { return _a;       }
+      int dataB() const             { return _b;       }
+      int pitch() const             { return _a;       }
+      int velo() const              { return _b;       }
+      void setVelo(int v)           { _b = v;          }
+      int controller() const        { return _a;       }
+      int value() const             { return _b;       }
+      float tuning() const          { return _tuning;  }
+      const Note* note() const      { return _note;    }
+      };
+
+Q_DECLARE_TYPEINFO(PlayEvent, Q_PRIMITIVE_TYPE);
+
 //---------------------------------------------------------
 //   EventList
-//   EventMap
 //---------------------------------------------------------
 
 class EventList : public QList<Event> {
@@ -199,7 +239,35 @@ class EventList : public QList<Event> {
       void insertNote(int channel, Note*);
       };
 
-class EventMap : public QMap<int, Event> {};
+//---------------------------------------------------------
+//   EventMap
+//    the playlist: a tick sorted array of PlayEvents
+//    Events are appended in any order, sort() must be
+//    called before the map is used for playback.
+//    Events with the same tick keep their order.
+//---------------------------------------------------------
+
+class EventMap {
+      QVector<PlayEvent> _events;
+      int _sorted;            // number of sorted events at start of _events
+
+   public:
+      typedef QVector<PlayEvent>::const_iterator const_iterator;
+
+      EventMap() : _sorted(0) {}
+      void add(const PlayEvent& e)        { _events.append(e);               }
+      void add(const QVector<PlayEvent>&, int tickOffset);
+      void sort();
+      void clear()                        { _events.clear(); _sorted = 0;    }
+      bool empty() const                  { return _events.isEmpty();        }
+      int size() const                    { return _events.size();           }
+      const PlayEvent& last() const       { return _events.last();           }
+      const_iterator begin() const        { return _events.constBegin();     }
+      const_iterator end() const          { return _events.constEnd();       }
+      const_iterator constBegin() const   { return _events.constBegin();     }
+      const_iterator constEnd() const     { return _events.constEnd();       }
+      const_iterator lowerBound(int tick) const;
+      };
 
 typedef EventList::iterator iEvent;
 typedef EventList::const_iterator ciEvent;
@@ -88,10 +88,11 @@ static void localSetScore(void* score, Element* element)
       }
 
 //---------------------------------------------------------
-//   createExcerpt
+//   cloneExcerpt
+//    create the part score without laying it out
 //---------------------------------------------------------
 
-Score* createExcerpt(const QList<Part*>& parts)
+static Score* cloneExcerpt(const QList<Part*>& parts)
       {
       if (parts.isEmpty())
             return 0;
@@ -153,10 +154,54 @@ Score* createExcerpt(const QList<Part*>& parts)
 
       score->setLayoutAll(true);
       score->addLayoutFlags(LAYOUT_FIX_TICKS | LAYOUT_FIX_PITCH_VELO);
-      score->doLayout();
       return score;
       }
 
+//---------------------------------------------------------
+//   createExcerpt
+//---------------------------------------------------------
+
+Score* createExcerpt(const QList<Part*>& parts)
+      {
+      Score* score = cloneExcerpt(parts);
+      if (score)
+            score->end2();    // full layout, clears the layout flags
+      return score;
+      }
+
+//---------------------------------------------------------
+//   layoutExcerpt
+//---------------------------------------------------------
+
+static void layoutExcerpt(Score* score)
+      {
+      score->end2();
+      }
+
+//---------------------------------------------------------
+//   createExcerpts
+//    create the part scores of all excerpts which have
+//    none yet. Cloning links the new elements to the
+//    source score and hands out link ids, it is done in
+//    order; the layout of the parts runs on the thread pool.
+//---------------------------------------------------------
+
+void createExcerpts(const QList<Excerpt*>& excerpts)
+      {
+      QList<Score*> scores;
+      foreach(Excerpt* e, excerpts) {
+            if (e->score())
+                  continue;
+            Score* score = cloneExcerpt(e->parts());
+            if (score) {
+                  score->setName(e->title());
+                  e->setScore(score);
+                  scores.append(score);
+                  }
+            }
+      QtConcurrent::blockingMap(scores, layoutExcerpt);
+      }
+
 //---------------------------------------------------------
 //   cloneStaves
 //---------------------------------------------------------
@@ -43,6 +43,7 @@ class Excerpt {
       };
 
 extern Score* createExcerpt(const QList<Part*>&);
+extern void createExcerpts(const QList<Excerpt*>&);
 extern void cloneStaves(Score* oscore, Score* score, const QList<int>& map);
 extern void cloneStaff(Staff* ostaff, Staff* nstaff);
 
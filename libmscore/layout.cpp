@@ -45,6 +45,7 @@
 #include "undo.h"
 #include "layout.h"
 #include "lyrics.h"
+#include "spanner.h"
 
 //---------------------------------------------------------
 //   rebuildBspTree
@@ -328,11 +329,16 @@ void Score::layoutChords1(Segment* segment, int staffIdx)
 //---------------------------------------------------------
 //   layoutStage2
 //    auto - beamer
+//    if fm and lm are given, only the measures fm - lm
+//    are processed
 //---------------------------------------------------------
 
-void Score::layoutStage2()
+void Score::layoutStage2(Measure* fm, Measure* lm)
       {
       int tracks = nstaves() * VOICES;
+      Segment::SegmentTypes st = Segment::SegChordRestGrace;
+      Segment* fs = fm ? fm->first(st) : firstSegment(st);
+      Measure* em = lm ? lm->nextMeasure() : 0;
 
       for (int track = 0; track < tracks; ++track) {
             ChordRest* a1    = 0;      // start of (potential) beam
@@ -340,8 +346,7 @@ void Score::layoutStage2()
             Measure* measure = 0;
 
             BeamMode bm = BEAM_AUTO;
-            Segment::SegmentTypes st = Segment::SegChordRestGrace;
-            for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st)) {
+            for (Segment* segment = fs; segment && segment->measure() != em; segment = segment->next1(st)) {
                   ChordRest* cr = static_cast<ChordRest*>(segment->element(track));
                   if (cr == 0)
                         continue;
@@ -510,13 +515,17 @@ void Score::layoutStage2()
 
 //---------------------------------------------------------
 //   layoutStage3
+//    if fm and lm are given, only the measures fm - lm
+//    are processed
 //---------------------------------------------------------
 
-void Score::layoutStage3()
+void Score::layoutStage3(Measure* fm, Measure* lm)
       {
       Segment::SegmentTypes st = Segment::SegChordRestGrace;
+      Segment* fs = fm ? fm->first(st) : firstSegment(st);
+      Measure* em = lm ? lm->nextMeasure() : 0;
       for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
-            for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st)) {
+            for (Segment* segment = fs; segment && segment->measure() != em; segment = segment->next1(st)) {
                   layoutChords1(segment, staffIdx);
                   }
             }
@@ -608,16 +617,34 @@ void Score::doLayout()
       //   place Spanner & beams
       //---------------------------------------------------
 
-      int tracks = nstaves * VOICES;
-      for (int track = 0; track < tracks; ++track) {
-            for (Segment* segment = firstSegment(); segment; segment = segment->next1()) {
-                  if (track == tracks-1) {
-                        for (Spanner* sp = segment->spannerFor(); sp; sp = sp->next())
-                              sp->layout();
-                        int n = segment->annotations().size();
-                        for (int i = 0; i < n; ++i)
-                              segment->annotations().at(i)->layout();
-                        }
+      placeElements(firstSegment(), 0);
+
+      if (layoutMode() != LayoutLine) {
+            layoutSystems2();
+            layoutPages();    // create list of pages
+            }
+
+      for (Measure* m = firstMeasure(); m; m = m->nextMeasure())
+            m->layout2();
+
+      rebuildBspTree();
+
+      }     // unlock mutex
+      notifyViewers();
+      }
+
+//---------------------------------------------------------
+//   layoutStaffElements
+//    lay out beams, stems, arpeggios, articulations and
+//    bar lines of one staff
+//---------------------------------------------------------
+
+static void layoutStaffElements(Segment* fs, Measure* em, int staffIdx)
+      {
+      int strack = staffIdx * VOICES;
+      int etrack = strack + VOICES;
+      for (Segment* segment = fs; segment && segment->measure() != em; segment = segment->next1()) {
+            for (int track = strack; track < etrack; ++track) {
                   Element* e = segment->element(track);
                   if (!e)
                         continue;
@@ -631,12 +658,6 @@ void Score::doLayout()
                               if (!c->beam())
                                     c->layoutStem();
                               c->layoutArpeggio2();
-                              int n = c->notes().size();
-                              for (int i = 0; i < n; ++i) {
-                                    Tie* tie = c->notes().at(i)->tieFor();
-                                    if (tie)
-                                          tie->layout();
-                                    }
                               }
                         cr->layoutArticulations();
                         }
@@ -644,22 +665,49 @@ void Score::doLayout()
                         e->layout();
                   }
             }
+      }
 
+//---------------------------------------------------------
+//   placeElements
+//    place beams, ties, spanners and annotations of all
+//    segments from fs up to measure em (0: end of score)
+//    in one walk per staff. Ties, spanners and annotations
+//    add their segments to the systems; they are laid out
+//    afterwards in one walk over the segments, in score
+//    order and after all chords are final.
+//    The walks are serial: beam layout can push undo
+//    commands (hook removal) and cross staff beams and
+//    arpeggios reach into other staves.
+//---------------------------------------------------------
 
-      if (layoutMode() != LayoutLine) {
-            layoutSystems2();
-            layoutPages();    // create list of pages
+void Score::placeElements(Segment* fs, Measure* em)
+      {
+      int n = nstaves();
+      for (int staffIdx = 0; staffIdx < n; ++staffIdx)
+            layoutStaffElements(fs, em, staffIdx);
+
+      int tracks = n * VOICES;
+      for (Segment* segment = fs; segment && segment->measure() != em; segment = segment->next1()) {
+            if (segment->subtype() & Segment::SegChordRestGrace) {
+                  for (int track = 0; track < tracks; ++track) {
+                        Element* e = segment->element(track);
+                        if (!e || e->type() != Element::CHORD)
+                              continue;
+                        const QList<Note*>& nl = static_cast<Chord*>(e)->notes();
+                        int nn = nl.size();
+                        for (int i = 0; i < nn; ++i) {
+                              Tie* tie = nl.at(i)->tieFor();
+                              if (tie)
+                                    tie->layout();
+                              }
+                        }
+                  }
+            for (Spanner* sp = segment->spannerFor(); sp; sp = sp->next())
+                  sp->layout();
+            int na = segment->annotations().size();
+            for (int i = 0; i < na; ++i)
+                  segment->annotations().at(i)->layout();
             }
-
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure())
-            m->layout2();
-
-      rebuildBspTree();
-
-      }     // unlock mutex
-      int n = viewer.size();
-      for (int i = 0; i < n; ++i)
-            viewer.at(i)->layoutChanged();
       }
 
 //-------------------------------------------------------------------
@@ -904,6 +952,65 @@ qreal Score::cautionaryWidth(Measure* m)
       return w;
       }
 
+//---------------------------------------------------------
+//   systemMeasureWidth
+//    return the minimum width measure m occupies in a
+//    system, including end bar line changes and stretch
+//---------------------------------------------------------
+
+qreal Score::systemMeasureWidth(Measure* m, bool isFirstMeasure)
+      {
+      qreal ww = isFirstMeasure ? m->minWidth2() : m->minWidth1();
+
+      Segment* s = m->last();
+      if ((s->subtype() == Segment::SegEndBarLine) && s->element(0)) {
+            BarLine*    bl = static_cast<BarLine*>(s->element(0));
+            BarLineType ot = bl->subtype();
+            BarLineType nt = m->endBarLineType();
+
+            if (m->repeatFlags() & RepeatEnd)
+                  nt = END_REPEAT;
+            else {
+                  Measure* nm = m->nextMeasure();
+                  if (nm && (nm->repeatFlags() & RepeatStart))
+                        nt = START_REPEAT;
+                  }
+            if (ot != nt) {
+                  qreal w =
+                     BarLine::layoutWidth(this, nt, bl->magS())
+                     - BarLine::layoutWidth(this, ot, bl->magS());
+                  ww += w;
+                  }
+            }
+      ww *= m->userStretch() * styleD(ST_measureSpacing);
+
+      qreal minMeasureWidth = point(styleS(ST_minMeasureWidth));
+      if (ww < minMeasureWidth)
+            ww = minMeasureWidth;
+      return ww;
+      }
+
+//---------------------------------------------------------
+//   systemBreakAfter
+//    return true if a system started by layoutSystem()
+//    must end after measure m, which is the n'th measure
+//    of the system
+//---------------------------------------------------------
+
+bool Score::systemBreakAfter(Measure* m, int n) const
+      {
+      MeasureBase* nm = _showVBox ? m->next() : m->nextMeasure();
+      Element::ElementType nt = nm ? nm->type() : Element::INVALID;
+      if (nt == Element::VBOX || nt == Element::TBOX || nt == Element::FBOX)
+            return true;
+      int fix = styleI(ST_FixMeasureNumbers);
+      if (fix && n >= fix)
+            return true;
+      if (_layoutMode == LayoutPage || _layoutMode == LayoutSystem)
+            return m->pageBreak() || m->lineBreak();
+      return false;
+      }
+
 //---------------------------------------------------------
 //   layoutSystem
 //    return true if line continues
@@ -931,8 +1038,6 @@ bool Score::layoutSystem(qreal& minWidth, qreal w, bool isFirstSystem, bool long
       Measure* firstMeasure = 0;
       Measure* lastMeasure  = 0;
 
-      qreal measureSpacing = styleD(ST_measureSpacing);
-
       for (; curMeasure;) {
             MeasureBase* nextMeasure;
             if (curMeasure->type() == Element::MEASURE) {
@@ -976,37 +1081,9 @@ bool Score::layoutSystem(qreal& minWidth, qreal w, bool isFirstSystem, bool long
                   if (isFirstMeasure) {
                         firstMeasure = m;
                         addSystemHeader(m, !isFirstSystem);
-                        ww = m->minWidth2();
                         }
-                  else
-                        ww = m->minWidth1();
-
-                  Segment* s = m->last();
-                  if ((s->subtype() == Segment::SegEndBarLine) && s->element(0)) {
-                        BarLine*    bl = static_cast<BarLine*>(s->element(0));
-                        BarLineType ot = bl->subtype();
-                        BarLineType nt = m->endBarLineType();
-
-                        if (m->repeatFlags() & RepeatEnd)
-                              nt = END_REPEAT;
-                        else {
-                              Measure* nm = m->nextMeasure();
-                              if (nm && (nm->repeatFlags() & RepeatStart))
-                                    nt = START_REPEAT;
-                              }
-                        if (ot != nt) {
-                              qreal w =
-                                 BarLine::layoutWidth(this, nt, bl->magS())
-                                 - BarLine::layoutWidth(this, ot, bl->magS());
-                              ww += w;
-                              }
-                        }
-                  qreal stretch = m->userStretch() * measureSpacing;
-                  cautionaryW   = 0.0; // TODO: cautionaryWidth(m) * stretch;
-                  ww           *= stretch;
-
-                  if (ww < minMeasureWidth)
-                        ww = minMeasureWidth;
+                  ww             = systemMeasureWidth(m, isFirstMeasure);
+                  cautionaryW    = 0.0; // TODO: cautionaryWidth(m) * stretch;
                   isFirstMeasure = false;
                   }
 
@@ -1496,114 +1573,205 @@ void Score::reLayout(Measure* m)
       startLayout = m;
       }
 
+//---------------------------------------------------------
+//   beamContinues
+//    return true if a beam from the previous measure
+//    continues into measure m
+//---------------------------------------------------------
+
+static bool beamContinues(Measure* m)
+      {
+      int tracks = m->score()->nstaves() * VOICES;
+      for (int track = 0; track < tracks; ++track) {
+            for (Segment* s = m->first(Segment::SegChordRest); s; s = s->next(Segment::SegChordRest)) {
+                  ChordRest* cr = static_cast<ChordRest*>(s->element(track));
+                  if (cr) {
+                        if (beamModeMid(cr->beamMode()))
+                              return true;
+                        break;
+                        }
+                  }
+            }
+      return false;
+      }
+
 //---------------------------------------------------------
 //   doReLayout
+//    relayout the system containing "startLayout"
 //    return true, if relayout was successful; if false
-//    a full layout must be done starting at "startLayout"
+//    a full layout must be done
+//
+//    The relayout fails if the system would get a
+//    different set of measures (the system breaks
+//    change) or if the edit can affect layout state
+//    outside of the system.
 //---------------------------------------------------------
 
 bool Score::doReLayout()
       {
-#if 0
-#if 0
-      if (startLayout->type() == Element::MEASURE)
-            static_cast<Measure*>(startLayout)->layout0();
-#endif
-      System* system  = startLayout->system();
-      qreal sysWidth  = system->width();
-      qreal minWidth = system->leftMargin();
+      if (startLayout == 0
+         || layoutFlags
+         || undoRedo()
+         || MScore::layoutDebug
+         || _layoutMode == LayoutLine
+         || styleB(ST_createMultiMeasureRests)
+         || styleB(ST_hideEmptyStaves))
+            return false;
 
-      //
-      //  check if measures still fit in system
-      //
-      MeasureBase* m = 0;
-      foreach(m, system->measures()) {
-            qreal ww;
-            if (m->type() == HBOX)
-                  ww = point(static_cast<Box*>(m)->boxWidth());
-            else {            // MEASURE
-                  Measure* measure = static_cast<Measure*>(m);
-//TODOXX                  measure->layout0();
-//TODO            measure->layoutBeams1();
+      System* system = startLayout->system();
+      if (system == 0 || system->isVbox() || system->page() == 0 || system->measures().isEmpty())
+            return false;
+      int sysIdx = _systems.indexOf(system);
+      if (sysIdx == -1 || system->sameLine()
+         || ((sysIdx + 1) < _systems.size() && _systems[sysIdx + 1]->sameLine()))
+            return false;
+      foreach (Staff* staff, _staves) {
+            if (staff->updateKeymap())
+                  return false;
+            }
+      const QList<MeasureBase*>& ml = system->measures();
+      foreach (MeasureBase* mb, ml) {
+            if (mb->type() != Element::MEASURE)
+                  return false;
+            }
+      Measure* fm = static_cast<Measure*>(ml.front());
+      Measure* lm = static_cast<Measure*>(ml.back());
+      Measure* em = lm->nextMeasure();
 
-                  measure->layoutX(1.0, true);
-                  ww      = measure->layoutWidth();
-                  qreal stretch = measure->userStretch() * styleD(ST_measureSpacing);
+      // the last system may be set ragged right, beams
+      // crossing the system boundaries are computed for
+      // the whole beam
+      if ((_showVBox ? lm->next() : em) == 0)
+            return false;
+      if (beamContinues(fm) || (em && beamContinues(em)))
+            return false;
 
-                  ww *= stretch;
-                  if (ww < point(styleS(ST_minMeasureWidth)))
-                        ww = point(styleS(ST_minMeasureWidth));
-                  }
-            minWidth += ww;
+      int staves          = system->staves()->size();
+      qreal oldHeight     = system->height();
+      qreal oldDistanceUp = system->distanceUp(0);
+      qreal oldDistanceDn = system->distanceDown(staves - 1);
+
+      /*--*/ {
+      QWriteLocker locker(&_layoutLock);
+
+      foreach (MeasureBase* mb, ml) {
+            mb->layout0();
+            static_cast<Measure*>(mb)->layoutStage1();
             }
-      if (minWidth > sysWidth)            // measure does not fit: do full layout
-            return false;
+      layoutStage2(fm, lm);
+      layoutStage3(fm, lm);
 
       //
-      // check if another measure will fit into system
+      //  check if the system still contains the same measures,
+      //  emulating the line breaking of layoutSystem()
       //
-      m = m->next();
-      if (m && m->type() == MEASURE) {
-            Measure* measure = static_cast<Measure*>(m);
-            measure->layoutX(1.0, true);
-            qreal ww      = measure->layoutWidth();
-            qreal stretch = measure->userStretch() * styleD(ST_measureSpacing);
-
-            ww *= stretch;
-            if (ww < point(styleS(ST_minMeasureWidth)))
-                  ww = point(styleS(ST_minMeasureWidth));
-            if ((minWidth + ww) <= sysWidth)    // if another measure fits, do full layout
+      qreal systemWidth     = pageFormat()->printableWidth() * MScore::DPI;
+      qreal minMeasureWidth = point(styleS(ST_minMeasureWidth));
+      qreal minWidth        = system->leftMargin();
+      int n                 = 0;
+      for (MeasureBase* mb = fm; mb;) {
+            if (mb->type() != Element::MEASURE)
                   return false;
+            Measure* m = static_cast<Measure*>(mb);
+            qreal ww   = systemMeasureWidth(m, n == 0);
+            if (n && (minWidth + ww > systemWidth))
+                  break;
+            ++n;
+            if (systemBreakAfter(m, n))
+                  break;
+            mb = _showVBox ? m->next() : m->nextMeasure();
+            if (minWidth + minMeasureWidth > systemWidth)
+                  break;
+            minWidth += ww;
             }
+      if (n != ml.size())
+            return false;
+
       //
-      // stretch measures
+      //  stretch measures (see layoutSystemRow())
       //
-      minWidth    = system->leftMargin();
+      minWidth          = 0.0;
       qreal totalWeight = 0.0;
-      foreach (MeasureBase* mb, system->measures()) {
-            if (mb->type() == HBOX)
-                  minWidth += point(static_cast<Box*>(mb)->boxWidth());
-            else {
-                  Measure* m   = static_cast<Measure*>(mb);
-                  minWidth    += m->layoutWidth();
-                  totalWeight += m->ticks() * m->userStretch();
-                  }
+      foreach (MeasureBase* mb, ml) {
+            Measure* m   = static_cast<Measure*>(mb);
+            minWidth    += m->minWidth2();
+            totalWeight += m->ticks() * m->userStretch();
             }
+      minWidth += system->leftMargin();
+      qreal rest = (systemWidth - minWidth) / totalWeight;
 
-      qreal rest = (sysWidth - minWidth) / totalWeight;
-
-      bool firstMeasure = true;
-      QPointF pos;
-      foreach(MeasureBase* mb, system->measures()) {
-            qreal ww = 0.0;
-            if (mb->type() == MEASURE) {
-                  if (firstMeasure) {
-                        pos.rx() += system->leftMargin();
-                        firstMeasure = false;
-                        }
-                  mb->setPos(pos);
-                  Measure* m    = static_cast<Measure*>(mb);
+      QPointF pos(system->leftMargin(), 0.0);
+      foreach (MeasureBase* mb, ml) {
+            Measure* m = static_cast<Measure*>(mb);
+            qreal ww;
+            if (styleB(ST_FixMeasureWidth))
+                  ww = systemWidth / ml.size();
+            else {
                   qreal weight = m->ticks() * m->userStretch();
-                  ww            = m->layoutWidth() + rest * weight;
-                  m->layout(ww);
-                  }
-            else if (mb->type() == HBOX) {
-                  mb->setPos(pos);
-                  ww = point(static_cast<Box*>(mb)->boxWidth());
-                  mb->layout();
+                  ww           = m->minWidth2() + rest * weight;
                   }
+            m->setPos(pos);
+            m->layout(ww);
             pos.rx() += ww;
             }
+      system->setWidth(pos.x());
+      system->layout2();
 
-      foreach(MeasureBase* mb, system->measures()) {
-            if (mb->type() == MEASURE)
-                  static_cast<Measure*>(mb)->layout2();
+      //
+      //  place spanner & beams of the system
+      //
+      placeElements(fm->first(), em);
+      system->layout2();
+
+      //
+      //  reflow pages only if the system height changed
+      //
+      bool reflow = system->height() != oldHeight
+         || system->distanceUp(0) != oldDistanceUp
+         || system->distanceDown(staves - 1) != oldDistanceDn;
+      if (reflow)
+            layoutPages();
+
+      foreach (MeasureBase* mb, ml)
+            static_cast<Measure*>(mb)->layout2();
+
+      //
+      //  spanners and ties from previous systems which extend
+      //  into this system; the system holds a segment of
+      //  every spanner crossing it
+      //
+      QList<Spanner*> spanner;
+      QList<Spanner*> prevSpanner;
+      foreach (SpannerSegment* ss, system->spannerSegments()) {
+            Spanner* sp = ss->spanner();
+            if (spanner.contains(sp))
+                  continue;
+            spanner.append(sp);
+            if (sp->spannerSegments().front() != ss)
+                  prevSpanner.append(sp);
             }
+      foreach (Spanner* sp, prevSpanner)
+            sp->layout();
 
-      rebuildBspTree();
+      if (reflow)
+            rebuildBspTree();
+      else {
+            QList<Page*> pl;
+            pl.append(system->page());
+            foreach (Spanner* sp, spanner) {
+                  foreach (SpannerSegment* ss, sp->spannerSegments()) {
+                        Page* page = ss->system() ? ss->system()->page() : 0;
+                        if (page && !pl.contains(page))
+                              pl.append(page);
+                        }
+                  }
+            foreach (Page* page, pl)
+                  page->rebuildBspTree();
+            }
+      }     // unlock mutex
+
+      notifyViewers();
       return true;
-#endif
-      return false;
       }
 
 //---------------------------------------------------------
@@ -1686,8 +1854,6 @@ QList<System*> Score::layoutSystemRow(qreal rowWidth, bool isFirstSystem, bool u
       //    "nm" measures fit on this line of score
       //-------------------------------------------------------
 
-      bool needRelayout = false;
-
       foreach (System* system, sl) {
             //
             //    add cautionary time/key signatures if needed
@@ -1885,7 +2051,8 @@ QList<System*> Score::layoutSystemRow(qreal rowWidth, bool isFirstSystem, bool u
                               if (mb && mb->type() == Element::MEASURE)
                                     nm = static_cast<Measure*>(mb);
 
-                              needRelayout |= m->setStartRepeatBarLine(fmr);
+                              // adding or removing the bar line marks m dirty
+                              m->setStartRepeatBarLine(fmr);
                               if (m->repeatFlags() & RepeatEnd) {
                                     if (nm && (nm->repeatFlags() & RepeatStart))
                                           m->setEndBarLineType(END_START_REPEAT, true);
@@ -1933,8 +2100,6 @@ QList<System*> Score::layoutSystemRow(qreal rowWidth, bool isFirstSystem, bool u
                         minWidth += point(((Box*)mb)->boxWidth());
                   else if (mb->type() == Element::MEASURE) {
                         Measure* m = (Measure*)mb;
-                        if (needRelayout)
-                              m->setDirty();
                         minWidth    += m->minWidth2();
                         totalWeight += m->ticks() * m->userStretch();
                         }
@@ -141,6 +141,7 @@ Measure::Measure(Score* s)
       _endBarLineType        = NORMAL_BAR;
       _mmEndBarLineType      = NORMAL_BAR;
       _multiMeasure          = 0;
+      _playEventsSerial      = -1;
       setFlag(ELEMENT_MOVABLE, true);
       }
 
@@ -179,6 +180,7 @@ Measure::Measure(const Measure& m)
       _mmEndBarLineType      = m._mmEndBarLineType;
       _multiMeasure          = m._multiMeasure;
       _playbackCount         = m._playbackCount;
+      _playEventsSerial      = -1;
       _endBarLineColor       = m._endBarLineColor;
       }
 
@@ -267,8 +269,8 @@ void Measure::remove(Segment* el)
             if (el->subtype() == Segment::SegKeySig)
                   score()->staff(track/VOICES)->setUpdateKeymap(true);
             }
+      setHeaderDirty(el);
       _segments.remove(el);
-      setDirty();
       }
 
 //---------------------------------------------------------
@@ -699,15 +701,11 @@ ChordRest* Measure::findChordRest(int tick, int track)
 
 Segment* Measure::tick2segment(int tick, bool grace) const
       {
-      for (Segment* s = first(); s; s = s->next()) {
-            if (s->tick() == tick) {
-                  if (grace && (s->subtype() == Segment::SegGrace))
-                        return s;
-                  if (s->subtype() == Segment::SegChordRest)
-                        return s;
-                  }
-            if (s->tick() > tick)
-                  return 0;
+      for (Segment* s = firstSegmentAt(tick); s && s->tick() == tick; s = s->next()) {
+            if (grace && (s->subtype() == Segment::SegGrace))
+                  return s;
+            if (s->subtype() == Segment::SegChordRest)
+                  return s;
             }
       return 0;
       }
@@ -722,11 +720,7 @@ Segment* Measure::tick2segment(int tick, bool grace) const
 
 Segment* Measure::findSegment(Segment::SegmentType st, int t)
       {
-      Segment* s;
-      for (s = first(); s && s->tick() < t; s = s->next())
-            ;
-
-      for (Segment* ss = s; ss && ss->tick() == t; ss = ss->next()) {
+      for (Segment* ss = firstSegmentAt(t); ss && ss->tick() == t; ss = ss->next()) {
             if (ss->subtype() == st)
                   return ss;
             }
@@ -852,9 +846,10 @@ Segment* Measure::getGraceSegment(int t, int gl)
 
 void Measure::add(Element* el)
       {
-      setDirty();
       el->setParent(this);
       ElementType type = el->type();
+      if (type != SEGMENT)
+            setDirty();
 
 //      if (MScore::debugMode)
 //            qDebug("measure %p(%d): add %s %p", this, _no, el->name(), el);
@@ -984,7 +979,8 @@ void Measure::add(Element* el)
                   MeasureBase::add(el);
                   break;
             }
-
+      if (type == SEGMENT)
+            setHeaderDirty(static_cast<Segment*>(el));
       }
 
 //---------------------------------------------------------
@@ -994,7 +990,8 @@ void Measure::add(Element* el)
 
 void Measure::remove(Element* el)
       {
-      setDirty();
+      if (el->type() != SEGMENT)
+            setDirty();       // remove(Segment*) knows better
       switch(el->type()) {
             case TEXT:
                   Q_ASSERT(el == _noText);
@@ -1887,11 +1884,11 @@ void Measure::read(XmlReader& e, int staffIdx)
       Fraction timeStretch(staff->timeStretch(tick()));
 
       while (e.readNextStartElement()) {
-            const QStringRef& tag(e.name());
+            const XmlTag tag = e.tag();
 
-            if (tag == "tick")
+            if (tag == TAG_tick)
                   e.setTick(e.readInt());
-            else if (tag == "BarLine") {
+            else if (tag == TAG_BarLine) {
                   BarLine* barLine = new BarLine(score());
                   barLine->setTrack(e.track());
                   barLine->read(e);
@@ -1912,7 +1909,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   segment->add(barLine);
                   }
-            else if (tag == "Chord") {
+            else if (tag == TAG_Chord) {
                   Chord* chord = new Chord(score());
                   chord->setTrack(e.track());
                   chord->read(e);
@@ -1991,7 +1988,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   segment->add(chord);
                   }
-            else if (tag == "Rest") {
+            else if (tag == TAG_Rest) {
                   Rest* rest = new Rest(score());
                   rest->setDurationType(TDuration::V_MEASURE);
                   rest->setDuration(timesig()/timeStretch);
@@ -2006,7 +2003,7 @@ void Measure::read(XmlReader& e, int staffIdx)
 
                   e.setTick(e.tick() + ts.ticks());
                   }
-            else if (tag == "Note") {                 // obsolete
+            else if (tag == TAG_Note) {                 // obsolete
                   Chord* chord = new Chord(score());
                   chord->setTrack(e.track());
                   chord->readNote(e);
@@ -2016,14 +2013,14 @@ void Measure::read(XmlReader& e, int staffIdx)
                   Fraction ts(timeStretch * chord->globalDuration());
                   e.setTick(e.tick() + ts.ticks());
                   }
-            else if (tag == "Breath") {
+            else if (tag == TAG_Breath) {
                   Breath* breath = new Breath(score());
                   breath->setTrack(e.track());
                   breath->read(e);
                   segment = getSegment(Segment::SegBreath, e.tick());
                   segment->add(breath);
                   }
-            else if (tag == "endSpanner") {
+            else if (tag == TAG_endSpanner) {
                   int id = e.attribute("id").toInt();
                   Spanner* spanner = score()->findSpanner(id);
                   if (spanner) {
@@ -2053,13 +2050,13 @@ void Measure::read(XmlReader& e, int staffIdx)
                         qDebug("Measure::read(): cannot find spanner %d", id);
                   e.readNext();
                   }
-            else if (tag == "HairPin"
-               || tag == "Pedal"
-               || tag == "Ottava"
-               || tag == "Trill"
-               || tag == "TextLine"
-               || tag == "Volta") {
-                  Spanner* sp = static_cast<Spanner*>(Element::name2Element(tag, score()));
+            else if (tag == TAG_HairPin
+               || tag == TAG_Pedal
+               || tag == TAG_Ottava
+               || tag == TAG_Trill
+               || tag == TAG_TextLine
+               || tag == TAG_Volta) {
+                  Spanner* sp = static_cast<Spanner*>(Element::name2Element(e.name(), score()));
                   e.addSpanner(sp);
                   sp->setTrack(staffIdx * VOICES);
                   sp->read(e);
@@ -2073,7 +2070,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         add(sp);
                         }
                   }
-            else if (tag == "RepeatMeasure") {
+            else if (tag == TAG_RepeatMeasure) {
                   RepeatMeasure* rm = new RepeatMeasure(score());
                   rm->setTrack(e.track());
                   rm->read(e);
@@ -2081,7 +2078,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment->add(rm);
                   e.setTick(e.tick() + ticks());
                   }
-            else if (tag == "Clef") {
+            else if (tag == TAG_Clef) {
                   Clef* clef = new Clef(score());
                   clef->setTrack(e.track());
                   clef->read(e);
@@ -2108,7 +2105,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   segment->add(clef);
                   }
-            else if (tag == "TimeSig") {
+            else if (tag == TAG_TimeSig) {
                   TimeSig* ts = new TimeSig(score());
                   ts->setTrack(e.track());
                   ts->read(e);
@@ -2133,7 +2130,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                               }
                         }
                   }
-            else if (tag == "KeySig") {
+            else if (tag == TAG_KeySig) {
                   KeySig* ks = new KeySig(score());
                   ks->setTrack(e.track());
                   ks->read(e);
@@ -2142,7 +2139,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment->add(ks);
                   staff->setKey(tick, ks->keySigEvent());
                   }
-            else if (tag == "Lyrics") {                           // obsolete
+            else if (tag == TAG_Lyrics) {                           // obsolete
                   Lyrics* lyrics = new Lyrics(score());
                   lyrics->setTrack(e.track());
                   lyrics->read(e);
@@ -2153,7 +2150,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                   else
                         cr->add(lyrics);
                   }
-            else if (tag == "Text") {
+            else if (tag == TAG_Text) {
                   Text* t = new Text(score());
                   t->setTrack(e.track());
                   t->read(e);
@@ -2170,7 +2167,7 @@ void Measure::read(XmlReader& e, int staffIdx)
             //----------------------------------------------------
             // Annotation
 
-            else if (tag == "Dynamic") {
+            else if (tag == TAG_Dynamic) {
                   Dynamic* dyn = new Dynamic(score());
                   dyn->setTrack(e.track());
                   dyn->read(e);
@@ -2178,25 +2175,25 @@ void Measure::read(XmlReader& e, int staffIdx)
                   segment = getSegment(Segment::SegChordRest, e.tick());
                   segment->add(dyn);
                   }
-            else if (tag == "Harmony"
-               || tag == "FretDiagram"
-               || tag == "Symbol"
-               || tag == "Tempo"
-               || tag == "StaffText"
-               || tag == "RehearsalMark"
-               || tag == "InstrumentChange"
-               || tag == "Marker"
-               || tag == "Jump"
-               || tag == "StaffState"
-               || tag == "FiguredBass"
+            else if (tag == TAG_Harmony
+               || tag == TAG_FretDiagram
+               || tag == TAG_Symbol
+               || tag == TAG_Tempo
+               || tag == TAG_StaffText
+               || tag == TAG_RehearsalMark
+               || tag == TAG_InstrumentChange
+               || tag == TAG_Marker
+               || tag == TAG_Jump
+               || tag == TAG_StaffState
+               || tag == TAG_FiguredBass
                ) {
-                  Element* el = Element::name2Element(tag, score());
+                  Element* el = Element::name2Element(e.name(), score());
                   el->setTrack(e.track());
                   el->read(e);
                   segment = getSegment(Segment::SegChordRest, e.tick());
                   segment->add(el);
                   }
-            else if (tag == "Image") {
+            else if (tag == TAG_Image) {
                   Image* image = new Image(score());
                   image->setTrack(e.track());
                   image->read(e);
@@ -2205,24 +2202,24 @@ void Measure::read(XmlReader& e, int staffIdx)
                   }
 
             //----------------------------------------------------
-            else if (tag == "stretch")
+            else if (tag == TAG_stretch)
                   _userStretch = e.readDouble();
-            else if (tag == "LayoutBreak") {
+            else if (tag == TAG_LayoutBreak) {
                   LayoutBreak* lb = new LayoutBreak(score());
                   lb->read(e);
                   add(lb);
                   }
-            else if (tag == "noOffset")
+            else if (tag == TAG_noOffset)
                   _noOffset = e.readInt();
-            else if (tag == "irregular") {
+            else if (tag == TAG_irregular) {
                   _irregular = true;
                   e.readNext();
                   }
-            else if (tag == "breakMultiMeasureRest") {
+            else if (tag == TAG_breakMultiMeasureRest) {
                   _breakMultiMeasureRest = true;
                   e.readNext();
                   }
-            else if (tag == "Tuplet") {
+            else if (tag == TAG_Tuplet) {
                   Tuplet* tuplet = new Tuplet(score());
                   tuplet->setTrack(e.track());
                   tuplet->setTick(e.tick());
@@ -2230,21 +2227,21 @@ void Measure::read(XmlReader& e, int staffIdx)
                   tuplet->read(e);
                   e.addTuplet(tuplet);
                   }
-            else if (tag == "startRepeat") {
+            else if (tag == TAG_startRepeat) {
                   _repeatFlags |= RepeatStart;
                   e.readNext();
                   }
-            else if (tag == "endRepeat") {
+            else if (tag == TAG_endRepeat) {
                   _repeatCount = e.readInt();
                   _repeatFlags |= RepeatEnd;
                   }
-            else if (tag == "Slur") {
+            else if (tag == TAG_Slur) {
                   Slur* slur = new Slur(score());
                   slur->setTrack(e.track());
                   slur->read(e);
                   e.addSpanner(slur);
                   }
-            else if (tag == "vspacer" || tag == "vspacerDown") {
+            else if (tag == TAG_vspacer || tag == TAG_vspacerDown) {
                   if (staves[staffIdx]->_vspacerDown == 0) {
                         Spacer* spacer = new Spacer(score());
                         spacer->setSubtype(SPACER_DOWN);
@@ -2253,7 +2250,7 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   staves[staffIdx]->_vspacerDown->setGap(e.readDouble() * _spatium);
                   }
-            else if (tag == "vspacer" || tag == "vspacerUp") {
+            else if (tag == TAG_vspacer || tag == TAG_vspacerUp) {
                   if (staves[staffIdx]->_vspacerUp == 0) {
                         Spacer* spacer = new Spacer(score());
                         spacer->setSubtype(SPACER_UP);
@@ -2262,20 +2259,20 @@ void Measure::read(XmlReader& e, int staffIdx)
                         }
                   staves[staffIdx]->_vspacerUp->setGap(e.readDouble() * _spatium);
                   }
-            else if (tag == "visible")
+            else if (tag == TAG_visible)
                   staves[staffIdx]->_visible = e.readInt();
-            else if (tag == "slashStyle")
+            else if (tag == TAG_slashStyle)
                   staves[staffIdx]->_slashStyle = e.readInt();
-            else if (tag == "Beam") {
+            else if (tag == TAG_Beam) {
                   Beam* beam = new Beam(score());
                   beam->setTrack(e.track());
                   beam->read(e);
                   beam->setParent(0);
                   e.addBeam(beam);
                   }
-            else if (tag == "Segment")
+            else if (tag == TAG_Segment)
                   segment->read(e);
-            else if (tag == "MeasureNumber") {
+            else if (tag == TAG_MeasureNumber) {
                   _noText = new Text(score());
                   _noText->read(e);
                   _noText->setParent(this);
@@ -2880,6 +2877,25 @@ void Measure::setDirty()
       _minWidth2 = 0.0;
       }
 
+//---------------------------------------------------------
+//   setHeaderDirty
+//    segment s or one of its elements changes; if s is
+//    part of the system header only the width with header
+//    is affected, minWidth1() skips these segments
+//---------------------------------------------------------
+
+void Measure::setHeaderDirty(const Segment* seg)
+      {
+      Segment* e = systemHeaderEnd();
+      for (Segment* s = first(); s != e; s = s->next()) {
+            if (s == seg) {
+                  _minWidth2 = 0.0;
+                  return;
+                  }
+            }
+      setDirty();
+      }
+
 //---------------------------------------------------------
 //   systemHeader
 ///   return true if the measure contains a system header
@@ -2902,23 +2918,30 @@ bool Measure::systemHeader() const
 qreal Measure::minWidth1() const
       {
       if (_minWidth1 == 0.0) {
-            Segment* s = first();
-            Segment::SegmentTypes st = Segment::SegClef | Segment::SegKeySig | Segment::SegStartRepeatBarLine;
-            for (;;) {
-                  if ((s->subtype() & st)
-                     && s->next()
-                     && (!s->element(0) || s->element(0)->generated())
-                     ) {
-                        s = s->next();
-                        }
-                  else
-                        break;
-                  }
-            _minWidth1 = score()->computeMinWidth(s);
+            Segment* s = systemHeaderEnd();
+            _minWidth1 = (s == first()) ? minWidth2() : score()->computeMinWidth(s);
             }
       return _minWidth1;
       }
 
+//---------------------------------------------------------
+//   systemHeaderEnd
+///   return the first segment after a (generated) system
+///   header; first() if there is none
+//---------------------------------------------------------
+
+Segment* Measure::systemHeaderEnd() const
+      {
+      Segment* s = first();
+      Segment::SegmentTypes st = Segment::SegClef | Segment::SegKeySig | Segment::SegStartRepeatBarLine;
+      while (s && (s->subtype() & st)
+         && s->next()
+         && (!s->element(0) || s->element(0)->generated())) {
+            s = s->next();
+            }
+      return s;
+      }
+
 //---------------------------------------------------------
 //   minWidth2
 ///   return minimum width of measure
@@ -2926,8 +2949,11 @@ qreal Measure::minWidth1() const
 
 qreal Measure::minWidth2() const
       {
-      if (_minWidth2 == 0.0)
+      if (_minWidth2 == 0.0) {
             _minWidth2 = score()->computeMinWidth(first());
+            if (_minWidth1 == 0.0 && systemHeaderEnd() == first())
+                  _minWidth1 = _minWidth2;      // no header, both are the same
+            }
       return _minWidth2;
       }
 
@@ -22,6 +22,7 @@
 #include "measurebase.h"
 #include "fraction.h"
 #include "segmentlist.h"
+#include "event.h"
 
 class Xml;
 class Beam;
@@ -123,6 +124,9 @@ class Measure : public MeasureBase {
       int _playbackCount;     // temp. value used in RepeatList
                               // counts how many times this measure was already played
 
+      QHash<const Part*, QVector<PlayEvent> > _playEvents;  ///< cached midi rendering per part
+      int _playEventsSerial;  ///< Score::renderSerial() of _playEvents, -1 if dirty
+
       QColor _endBarLineColor;
 
       void push_back(Segment* e);
@@ -171,7 +175,14 @@ class Measure : public MeasureBase {
       void setMinWidth1(qreal w)           { _minWidth1 = w;      }
       void setMinWidth2(qreal w)           { _minWidth2 = w;      }
       bool systemHeader() const;
+      Segment* systemHeaderEnd() const;
       void setDirty();
+      void setHeaderDirty(const Segment*);
+
+      QHash<const Part*, QVector<PlayEvent> >& playEvents() { return _playEvents; }
+      int playEventsSerial() const         { return _playEventsSerial; }
+      void setPlayEventsSerial(int n)      { _playEventsSerial = n;    }
+      void setPlaybackDirty()              { _playEventsSerial = -1;   }
 
       Fraction timesig() const             { return _timesig;     }
       void setTimesig(const Fraction& f)   { _timesig = f;        }
@@ -186,6 +197,7 @@ class Measure : public MeasureBase {
 
       Q_INVOKABLE Segment* last() const    { return _segments.last(); }
       Segment* firstCRSegment() const      { return _segments.firstCRSegment(); }
+      Segment* firstSegmentAt(int t) const { return _segments.lowerBound(t - tick()); }
       void remove(Segment* s);
       SegmentList* segments()              { return &_segments; }
 
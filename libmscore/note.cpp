@@ -711,64 +711,64 @@ void Note::read(XmlReader& e)
             _tpc = e.intAttribute("tpc");
 
       while (e.readNextStartElement()) {
-            const QStringRef& tag(e.name());
-            if (tag == "pitch")
+            const XmlTag tag = e.tag();
+            if (tag == TAG_pitch)
                   _pitch = e.readInt();
-            else if (tag == "tpc")
+            else if (tag == TAG_tpc)
                   _tpc = e.readInt();
-            else if (tag == "small")
+            else if (tag == TAG_small)
                   setSmall(e.readInt());
-            else if (tag == "mirror")
+            else if (tag == TAG_mirror)
                   setProperty(P_MIRROR_HEAD, ::getProperty(P_MIRROR_HEAD, e));
-            else if (tag == "dotPosition")
+            else if (tag == TAG_dotPosition)
                   setProperty(P_DOT_POSITION, ::getProperty(P_DOT_POSITION, e));
-            else if (tag == "onTimeOffset")
+            else if (tag == TAG_onTimeOffset)
                   ; // TODO setOnTimeUserOffset(val.toInt());
-            else if (tag == "offTimeOffset")
+            else if (tag == TAG_offTimeOffset)
                   ; // TODO setOffTimeUserOffset(val.toInt());
-            else if (tag == "head")
+            else if (tag == TAG_head)
                   setProperty(P_HEAD_GROUP, ::getProperty(P_HEAD_GROUP, e));
-            else if (tag == "velocity")
+            else if (tag == TAG_velocity)
                   setVeloOffset(e.readInt());
-            else if (tag == "tuning")
+            else if (tag == TAG_tuning)
                   setTuning(e.readDouble());
-            else if (tag == "fret")
+            else if (tag == TAG_fret)
                   setFret(e.readInt());
-            else if (tag == "string")
+            else if (tag == TAG_string)
                   setString(e.readInt());
-            else if (tag == "ghost")
+            else if (tag == TAG_ghost)
                   setGhost(e.readInt());
-            else if (tag == "headType")
+            else if (tag == TAG_headType)
                   setProperty(P_HEAD_TYPE, ::getProperty(P_HEAD_TYPE, e));
-            else if (tag == "veloType")
+            else if (tag == TAG_veloType)
                   setProperty(P_VELO_TYPE, ::getProperty(P_VELO_TYPE, e));
-            else if (tag == "line")
+            else if (tag == TAG_line)
                   _line = e.readInt();
-            else if (tag == "Tie") {
+            else if (tag == TAG_Tie) {
                   _tieFor = new Tie(score());
                   _tieFor->setTrack(track());
                   _tieFor->read(e);
                   _tieFor->setStartNote(this);
                   }
-            else if (tag == "Fingering" || tag == "Text") {       // Text is obsolete
+            else if (tag == TAG_Fingering || tag == TAG_Text) {       // Text is obsolete
                   Fingering* f = new Fingering(score());
                   f->setTextStyle(score()->textStyle(TEXT_STYLE_FINGERING));
                   f->read(e);
                   add(f);
                   }
-            else if (tag == "Symbol") {
+            else if (tag == TAG_Symbol) {
                   Symbol* s = new Symbol(score());
                   s->setTrack(track());
                   s->read(e);
                   add(s);
                   }
-            else if (tag == "Image") {
+            else if (tag == TAG_Image) {
                   Image* image = new Image(score());
                   image->setTrack(track());
                   image->read(e);
                   add(image);
                   }
-            else if (tag == "userAccidental") {
+            else if (tag == TAG_userAccidental) {
                   QString val(e.readElementText());
                   bool ok;
                   int k = val.toInt(&ok);
@@ -832,7 +832,7 @@ void Note::read(XmlReader& e)
                         hasAccidental = true;   // we now have an accidental
                         }
                   }
-            else if (tag == "Accidental") {
+            else if (tag == TAG_Accidental) {
                   // on older scores, a note could have both a <userAccidental> tag and an <Accidental> tag
                   // if a userAccidental has some other property set (like for instance offset)
                   Accidental* a;
@@ -849,15 +849,15 @@ void Note::read(XmlReader& e)
                   if (score()->mscVersion() < 117)
                         hasAccidental = true;   // we now have an accidental
                   }
-            else if (tag == "move")             // obsolete
+            else if (tag == TAG_move)           // obsolete
                   chord()->setStaffMove(e.readInt());
-            else if (tag == "Bend") {
+            else if (tag == TAG_Bend) {
                   Bend* b = new Bend(score());
                   b->setTrack(track());
                   b->read(e);
                   add(b);
                   }
-            else if (tag == "NoteDot") {
+            else if (tag == TAG_NoteDot) {
                   NoteDot* dot = new NoteDot(score());
                   dot->read(e);
                   for (int i = 0; i < 3; ++i) {
@@ -873,10 +873,10 @@ void Note::read(XmlReader& e)
                         delete dot;
                         }
                   }
-            else if (tag == "Events") {
+            else if (tag == TAG_Events) {
                   while (e.readNextStartElement()) {
-                        const QStringRef& tag(e.name());
-                        if (tag == "Event") {
+                        const XmlTag tag = e.tag();
+                        if (tag == TAG_Event) {
                               NoteEvent ne;
                               ne.read(e);
                               _playEvents.append(ne);
@@ -887,7 +887,7 @@ void Note::read(XmlReader& e)
                   if (chord())
                         chord()->setUserPlayEvents(true);
                   }
-            else if (tag == "endSpanner") {
+            else if (tag == TAG_endSpanner) {
                   int id = e.intAttribute("id");
                   Spanner* e = score()->findSpanner(id);
                   if (e) {
@@ -897,8 +897,8 @@ void Note::read(XmlReader& e)
                   else
                         qDebug("Note::read(): cannot find spanner %d", id);
                   }
-            else if (tag == "TextLine") {
-                  Spanner* sp = static_cast<Spanner*>(Element::name2Element(tag, score()));
+            else if (tag == TAG_TextLine) {
+                  Spanner* sp = static_cast<Spanner*>(Element::name2Element(e.name(), score()));
                   sp->setTrack(track());
                   sp->read(e);
                   sp->setAnchor(Spanner::ANCHOR_NOTE);
@@ -907,11 +907,11 @@ void Note::read(XmlReader& e)
                   sp->setParent(this);
                   e.addSpanner(sp);
                   }
-            else if (tag == "onTimeType")                   // obsolete
+            else if (tag == TAG_onTimeType)                 // obsolete
                   ; // _onTimeType = readValueType(e);
-            else if (tag == "offTimeType")                  // obsolete
+            else if (tag == TAG_offTimeType)                // obsolete
                   ; // _offTimeType = readValueType(e);
-            else if (tag == "tick")                         // bad input file
+            else if (tag == TAG_tick)                       // bad input file
                   ;
             else if (Element::readProperties(e))
                   ;
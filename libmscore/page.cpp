@@ -124,17 +124,90 @@ const PaperSize* getPaperSize(const qreal wi, const qreal hi)
 //   Page
 //---------------------------------------------------------
 
+static QAtomicInt pageGeneration;
+
 Page::Page(Score* s)
    : Element(s),
    _no(0)
       {
       bspTreeValid = false;
+      _generation  = pageGeneration.fetchAndAddOrdered(1) + 1;
+      _contentHash = 0;
       }
 
 Page::~Page()
       {
       }
 
+//---------------------------------------------------------
+//   hashShape
+//---------------------------------------------------------
+
+static uint hashShape(const QPainterPath& path)
+      {
+      uint h = path.elementCount();
+      for (int i = 0; i < path.elementCount(); ++i) {
+            const QPainterPath::Element& pe = path.elementAt(i);
+            h = h * 31 + qHash(qRound64(pe.x * 64.0));
+            h = h * 31 + qHash(qRound64(pe.y * 64.0));
+            }
+      return h;
+      }
+
+//---------------------------------------------------------
+//   hashElement
+//    position, size, shape, subtype, color, state and
+//    text of an element; other changes reach the tiles
+//    only through the refresh region of the edit
+//---------------------------------------------------------
+
+static void hashElement(void* data, Element* e)
+      {
+      uint* hash = static_cast<uint*>(data);
+      QRectF r(e->canvasBoundingRect());
+      uint h = qHash(quintptr(e)) ^ (uint(e->type()) << 24);
+      h = h * 31 + qHash(qRound64(r.x() * 64.0));
+      h = h * 31 + qHash(qRound64(r.y() * 64.0));
+      h = h * 31 + qHash(qRound64(r.width() * 64.0));
+      h = h * 31 + qHash(qRound64(r.height() * 64.0));
+      h = h * 31 + e->color().rgba();
+      h = h * 31 + (e->visible() ? 1 : 0) + (e->selected() ? 2 : 0);
+      h = h * 31 + hashShape(e->shape());
+      QVariant subtype(e->getProperty(P_SUBTYPE));
+      if (subtype.isValid())
+            h = h * 31 + uint(subtype.toInt());
+      if (e->isText())
+            h = h * 31 + qHash(static_cast<Text*>(e)->getText());
+      *hash = *hash * 31 + h;
+      }
+
+//---------------------------------------------------------
+//   updateGeneration
+//    the generation is unique over all pages, a cached
+//    rendering of a page is valid as long as it matches.
+//    A new generation is only assigned if the content
+//    of the page changed.
+//---------------------------------------------------------
+
+void Page::updateGeneration()
+      {
+      uint h = (score()->showInvisible()   ? 1 : 0)
+             | (score()->showUnprintable() ? 2 : 0)
+             | (score()->showFrames()      ? 4 : 0)
+             | (score()->showPageborders() ? 8 : 0);
+      h = h * 31 + _no;                   // header and footer macros
+      h = h * 31 + score()->npages();
+      foreach(System* s, _systems) {
+            foreach(MeasureBase* m, s->measures())
+                  m->scanElements(&h, hashElement, false);
+            }
+      scanElements(&h, hashElement, false);
+      if (h != _contentHash) {
+            _contentHash = h;
+            _generation  = pageGeneration.fetchAndAddOrdered(1) + 1;
+            }
+      }
+
 //---------------------------------------------------------
 //   items
 //---------------------------------------------------------
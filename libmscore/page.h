@@ -128,6 +128,8 @@ class Page : public Element {
       void doRebuildBspTree();
 #endif
       bool bspTreeValid;
+      int _generation;              // changes whenever the page content changes
+      uint _contentHash;
 
       QString replaceTextMacros(const QString&) const;
       void drawStyledHeaderFooter(QPainter*, int area, const QPointF&, const QString&) const;
@@ -160,6 +162,8 @@ class Page : public Element {
       QList<const Element*> items(const QRectF& r);
       QList<const Element*> items(const QPointF& p);
       void rebuildBspTree()   { bspTreeValid = false; }
+      void updateGeneration();
+      int generation() const  { return _generation; }
       QPointF pagePos() const { return QPointF(); }     ///< position in page coordinates
       QList<System*> searchSystem(const QPointF& pos) const;
       Measure* searchMeasure(const QPointF& p) const;
@@ -106,32 +106,28 @@ void Score::updateChannel()
 //   playNote
 //---------------------------------------------------------
 
-static void playNote(EventMap* events, const Note* note, int channel, int pitch,
+static void playNote(QVector<PlayEvent>* events, const Note* note, int channel, int pitch,
    int velo, int onTime, int offTime)
       {
       velo = note->customizeVelocity(velo);
-      Event ev(ME_NOTEON);
-      ev.setChannel(channel);
-      ev.setPitch(pitch);
-      ev.setVelo(velo);
-      ev.setTuning(note->tuning());
-      ev.setNote(note);
-      events->insertMulti(onTime, ev);
+      PlayEvent ev(onTime, ME_NOTEON, channel, pitch, velo, note->tuning(), note);
+      events->append(ev);
+      ev.setTick(offTime);
       ev.setVelo(0);
-      events->insertMulti(offTime, ev);
+      events->append(ev);
       }
 
 //---------------------------------------------------------
 //   collectNote
 //---------------------------------------------------------
 
-static void collectNote(EventMap* events, int channel, const Note* note, int velo, int tickOffset)
+static void collectNote(QVector<PlayEvent>* events, int channel, const Note* note, int velo)
       {
       if (note->hidden() || note->tieBack())       // do not play overlapping notes
             return;
 
       int pitch = note->ppitch();
-      int tick1 = note->chord()->tick() + tickOffset;
+      int tick1 = note->chord()->tick();
 
       int ticks = note->playTicks();
       foreach(const NoteEvent& e, note->playEvents()) {
@@ -213,7 +209,7 @@ struct OttavaShiftSegment {
 //   collectMeasureEvents
 //---------------------------------------------------------
 
-static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int tickOffset)
+static void collectMeasureEvents(QVector<PlayEvent>* events, Measure* m, Part* part)
       {
       int firstStaffIdx = m->score()->staffIdx(part);
       int nextStaffIdx  = firstStaffIdx + part->nstaves();
@@ -241,7 +237,7 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int t
 
                   int channel = instr->channel(chord->upNote()->subchannel()).channel;
                   foreach(const Note* note, chord->notes())
-                        collectNote(events, channel, note, velocity, tickOffset);
+                        collectNote(events, channel, note, velocity);
                   }
             }
 
@@ -256,7 +252,7 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int t
                      || e->staffIdx() >= nextStaffIdx)
                         continue;
                   const StaffText* st = static_cast<const StaffText*>(e);
-                  int tick = s->tick() + tickOffset;
+                  int tick = s->tick();
 
                   Instrument* instr = e->staff()->part()->instr(tick);
                   foreach (const ChannelActions& ca, *st->channelActions()) {
@@ -265,12 +261,9 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int t
                               NamedEventList* nel = instr->midiAction(ma, channel);
                               if (!nel)
                                     continue;
-                              int n = nel->events.size();
-                              for (int i = n-1; i >= 0; --i) {
-                                    Event event(nel->events[i]);
-                                    event.setOntime(tick);
-                                    event.setChannel(channel);
-                                    events->insertMulti(tick, event);
+                              foreach(const Event& ne, nel->events) {
+                                    events->append(PlayEvent(tick, ne.type(), channel,
+                                       ne.dataA(), ne.dataB(), ne.tuning(), ne.note()));
                                     }
                               }
                         }
@@ -279,27 +272,15 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int t
                         int voice   = 0;
                         int channel = staff->channel(tick, voice);
 
+                        // events at the same tick are played in insertion order:
+                        // clear group, set group mode, then switch on the stops
                         for (int i = 0; i < 4; ++i) {
+                              events->append(PlayEvent(tick, ME_CONTROLLER, channel, 98, 64 + i));
+                              events->append(PlayEvent(tick, ME_CONTROLLER, channel, 98, 96 + i));
                               for (int k = 0; k < 16; ++k) {
-                                    if (st->getAeolusStop(i, k)) {
-                                          Event event;
-                                          event.setType(ME_CONTROLLER);
-                                          event.setController(98);
-                                          event.setValue(k);
-                                          event.setOntime(tick);
-                                          event.setChannel(channel);
-                                          events->insertMulti(tick, event);
-                                          }
+                                    if (st->getAeolusStop(i, k))
+                                          events->append(PlayEvent(tick, ME_CONTROLLER, channel, 98, k));
                                     }
-                              Event event(ME_CONTROLLER);
-                              event.setController(98);
-                              event.setValue(96 + i);
-                              event.setOntime(tick);
-                              event.setChannel(channel);
-                              events->insertMulti(tick, event);
-
-                              event.setValue(64 + i);
-                              events->insertMulti(tick, event);
                               }
                         }
                   }
@@ -318,15 +299,10 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Part* part, int t
 
                         int channel = staff->channel(s1->tick(), 0);
 
-                        Event event(ME_CONTROLLER);
-                        event.setChannel(channel);
-                        event.setController(CTRL_SUSTAIN);
-
-                        event.setValue(127);
-                        events->insertMulti(s1->tick() + tickOffset, event);
-
-                        event.setValue(0);
-                        events->insertMulti(s2->tick() + tickOffset - 1, event);
+                        events->append(PlayEvent(s1->tick(), ME_CONTROLLER,
+                           channel, CTRL_SUSTAIN, 127));
+                        events->append(PlayEvent(s2->tick() - 1, ME_CONTROLLER,
+                           channel, CTRL_SUSTAIN, 0));
                         }
                   }
             }
@@ -352,12 +328,13 @@ void Score::updateRepeatList(bool expandRepeats)
             s->utime = 0.0;
             s->timeOffset = 0.0;
             repeatList()->append(s);
+            repeatList()->update();
             }
       else
             repeatList()->unwind();
       if (MScore::debugMode)
             repeatList()->dump();
-      setPlaylistDirty(true);
+      _playlistDirty = true;        // measure events do not depend on the unrolling
       }
 
 //---------------------------------------------------------
@@ -509,8 +486,75 @@ void Score::updateVelo()
             }
       }
 
+//---------------------------------------------------------
+//   renderMeasure
+//    Return the midi events of part in measure m at
+//    score ticks. The events are cached in the measure
+//    until the measure is marked dirty or the render
+//    serial of the score changes.
+//---------------------------------------------------------
+
+const QVector<PlayEvent>& Score::renderMeasure(Measure* m, Part* part)
+      {
+      if (m->playEventsSerial() != _renderSerial) {
+            m->playEvents().clear();
+            m->setPlayEventsSerial(_renderSerial);
+            }
+      QHash<const Part*, QVector<PlayEvent> >& cache = m->playEvents();
+      QHash<const Part*, QVector<PlayEvent> >::iterator i = cache.find(part);
+      if (i == cache.end()) {
+            i = cache.insert(part, QVector<PlayEvent>());
+            collectMeasureEvents(&i.value(), m, part);
+            }
+      return i.value();
+      }
+
+//---------------------------------------------------------
+//   setPlaybackDirty
+//    invalidate all cached measure events
+//---------------------------------------------------------
+
+void Score::setPlaybackDirty()
+      {
+      ++_renderSerial;
+      _playlistDirty = true;
+      }
+
+//---------------------------------------------------------
+//   setPlaybackDirty
+//    Invalidate the cached events of measure m. A tie
+//    chain is rendered by its first note, so measures
+//    where chains into m start are invalidated too, as
+//    is the next measure which may hold the end of a
+//    changed tie.
+//---------------------------------------------------------
+
+void Score::setPlaybackDirty(Measure* m)
+      {
+      m->setPlaybackDirty();
+      if (m->nextMeasure())
+            m->nextMeasure()->setPlaybackDirty();
+      Segment::SegmentTypes st = Segment::SegChordRestGrace;
+      for (Segment* s = m->first(st); s; s = s->next(st)) {
+            foreach(Element* e, s->elist()) {
+                  if (e == 0 || e->type() != Element::CHORD)
+                        continue;
+                  foreach(Note* note, static_cast<Chord*>(e)->notes()) {
+                        Note* n = note;
+                        while (n->tieBack())
+                              n = n->tieBack()->startNote();
+                        if (n != note)
+                              n->chord()->measure()->setPlaybackDirty();
+                        }
+                  }
+            }
+      _playlistDirty = true;
+      }
+
 //---------------------------------------------------------
 //   renderPart
+//    splice the cached measure events through the
+//    unrolled repeat list
 //---------------------------------------------------------
 
 void Score::renderPart(EventMap* events, Part* part)
@@ -523,16 +567,17 @@ void Score::renderPart(EventMap* events, Part* part)
             for (Measure* m = tick2measure(startTick); m; m = m->nextMeasure()) {
                   if (lastMeasure && m->isRepeatMeasure(part)) {
                         int offset = m->tick() - lastMeasure->tick();
-                        collectMeasureEvents(events, lastMeasure, part, tickOffset + offset);
+                        events->add(renderMeasure(lastMeasure, part), tickOffset + offset);
                         }
                   else {
                         lastMeasure = m;
-                        collectMeasureEvents(events, m, part, tickOffset);
+                        events->add(renderMeasure(m, part), tickOffset);
                         }
                   if (m->tick() + m->ticks() >= endTick)
                         break;
                   }
             }
+      events->sort();
       }
 
 //---------------------------------------------------------
@@ -790,7 +835,12 @@ void createPlayEvents(Chord* chord)
       createPlayEvents(chord, gateTime(chord), gl);
       }
 
-static void createPlayEvents(Measure* m, int track, QList<Slur*>* slurs)
+//---------------------------------------------------------
+//   createPlayEvents
+//    if create is false only the slur state is updated
+//---------------------------------------------------------
+
+static void createPlayEvents(Measure* m, int track, QList<Slur*>* slurs, bool create)
       {
       // skip linked staves, except primary
       if (!m->score()->staff(track / VOICES)->primaryStaff())
@@ -809,7 +859,7 @@ static void createPlayEvents(Measure* m, int track, QList<Slur*>* slurs)
                   if (spanner->type() == Element::SLUR)
                         slurs->removeOne(static_cast<Slur*>(spanner));
                   }
-            if (cr->type() != Element::CHORD)
+            if (!create || cr->type() != Element::CHORD)
                   continue;
             Chord* chord = static_cast<Chord*>(cr);
             if (chord->noteType() != NOTE_NORMAL) {
@@ -827,13 +877,28 @@ static void createPlayEvents(Measure* m, int track, QList<Slur*>* slurs)
             }
       }
 
-void Score::createPlayEvents()
+//---------------------------------------------------------
+//   createPlayEvents
+//    if dirtyOnly is set, create play events only for
+//    measures without valid cached midi events
+//---------------------------------------------------------
+
+void Score::createPlayEvents(bool dirtyOnly)
       {
+      if (dirtyOnly) {
+            Measure* m = firstMeasure();
+            while (m && m->playEventsSerial() == _renderSerial)
+                  m = m->nextMeasure();
+            if (m == 0)
+                  return;
+            }
       QList<Slur*> slurs;
       int etrack = nstaves() * VOICES;
       for (int track = 0; track < etrack; ++track) {
-            for (Measure* m = firstMeasure(); m; m = m->nextMeasure())
-                  ::createPlayEvents(m, track, &slurs);
+            for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+                  bool create = !dirtyOnly || m->playEventsSerial() != _renderSerial;
+                  ::createPlayEvents(m, track, &slurs, create);
+                  }
             }
       }
 
@@ -844,7 +909,7 @@ void Score::createPlayEvents()
 
 void Score::renderMidi(EventMap* events)
       {
-      createPlayEvents();
+      createPlayEvents(true);
 
       updateRepeatList(MScore::playRepeats);
       _foundPlayPosAfterRepeats = false;
@@ -865,13 +930,12 @@ void Score::renderMidi(EventMap* events)
                   int tw = MScore::division * 4 / ts.denominator();
                   for (int i = 0; i < ts.numerator(); i++) {
                         int tick = m->tick() + i * tw + tickOffset;
-                        Event event;
-                        event.setType(i == 0 ? ME_TICK1 : ME_TICK2);
-                        events->insertMulti(tick, event);
+                        events->add(PlayEvent(tick, i == 0 ? ME_TICK1 : ME_TICK2, 0, 0, 0));
                         }
                   if (m->tick() + m->ticks() >= endTick)
                         break;
                   }
             }
+      events->sort();
       }
 
@@ -18,6 +18,7 @@
 #include "tempo.h"
 #include "volta.h"
 #include "segment.h"
+#include <algorithm>
 
 //---------------------------------------------------------
 //   searchVolta
@@ -116,9 +117,13 @@ RepeatSegment::RepeatSegment()
 
 RepeatList::RepeatList(Score* s)
       {
-      _score = s;
-      idx1  = 0;
-      idx2  = 0;
+      _score  = s;
+      _serial = 0;
+      }
+
+RepeatList::~RepeatList()
+      {
+      qDeleteAll(_tables);
       }
 
 //---------------------------------------------------------
@@ -135,10 +140,10 @@ int RepeatList::ticks()
       }
 
 //---------------------------------------------------------
-//   update
+//   updateTimes
 //---------------------------------------------------------
 
-void RepeatList::update()
+void RepeatList::updateTimes()
       {
       const TempoMap* tl = _score->tempomap();
 
@@ -155,21 +160,187 @@ void RepeatList::update()
             }
       }
 
+//---------------------------------------------------------
+//   update
+//    recompute segment times and publish a new time
+//    table; gui thread only
+//---------------------------------------------------------
+
+void RepeatList::update()
+      {
+      updateTimes();
+      RepeatTimeTable* t = createTimeTable();
+      t->serial = ++_serial;
+      addTimeTable(t);
+      _staged.fetchAndStoreOrdered(0);
+      _table.fetchAndStoreOrdered(t);
+      }
+
+//---------------------------------------------------------
+//   stageUpdate
+//    as update() but the new table is installed by the
+//    next commitTimeTable(); the sequencer uses this to
+//    switch tables and its play position together
+//---------------------------------------------------------
+
+void RepeatList::stageUpdate()
+      {
+      updateTimes();
+      RepeatTimeTable* t = createTimeTable();
+      t->serial = ++_serial;
+      addTimeTable(t);
+      _staged.fetchAndStoreOrdered(t);
+      }
+
+//---------------------------------------------------------
+//   commitTimeTable
+//    install the staged table; does not allocate and can
+//    be called from the audio thread
+//---------------------------------------------------------
+
+void RepeatList::commitTimeTable()
+      {
+      RepeatTimeTable* t = _staged.fetchAndStoreOrdered(0);
+      if (t) {
+            // update() may have published a newer table since;
+            // the current table never gets older
+            RepeatTimeTable* old = _table;
+            if (old == 0 || old->serial < t->serial)
+                  _table.testAndSetOrdered(old, t);
+            }
+      }
+
+//---------------------------------------------------------
+//   ackTimeTable
+//    called by the audio thread at the end of each block,
+//    when it holds no table pointer. Its later lookups
+//    and commits only see the current or newer tables,
+//    older ones can be deleted by addTimeTable().
+//---------------------------------------------------------
+
+void RepeatList::ackTimeTable()
+      {
+      const RepeatTimeTable* t = _table;
+      if (t)
+            _acked.fetchAndStoreOrdered(t->serial);
+      }
+
+//---------------------------------------------------------
+//   timeTableValid
+//    false if the tempo map changed since the last update
+//---------------------------------------------------------
+
+bool RepeatList::timeTableValid() const
+      {
+      const RepeatTimeTable* t = _staged;
+      if (!t)
+            t = _table;
+      return t && t->tempoSN == _score->tempomap()->tempoSN();
+      }
+
+//---------------------------------------------------------
+//   addTimeTable
+//    Tables are deleted once the audio thread acknowledged
+//    a newer one, a lookup there may still hold a pointer
+//    to an older table. Without a running sequencer the
+//    tables are kept until the score is deleted.
+//---------------------------------------------------------
+
+void RepeatList::addTimeTable(RepeatTimeTable* t)
+      {
+      _tables.append(t);
+      int acked = _acked;
+      while (!_tables.isEmpty() && _tables.front()->serial < acked)
+            delete _tables.takeFirst();
+      }
+
+//---------------------------------------------------------
+//   createTimeTable
+//    flatten repeat segments and tempo map into
+//    binary searchable tables
+//---------------------------------------------------------
+
+RepeatTimeTable* RepeatList::createTimeTable() const
+      {
+      const TempoMap* tl = _score->tempomap();
+      qreal rel = MScore::division * tl->relTempo();
+
+      RepeatTimeTable* t = new RepeatTimeTable;
+      foreach(const RepeatSegment* s, *this) {
+            int offset = s->utick - s->tick;
+            RepeatTime rt;
+            rt.utick = s->utick;
+            rt.tick  = s->tick;
+            rt.time  = s->utime;
+            rt.tempo = tl->tempo(s->tick) * rel;
+            t->time.append(rt);
+            for (ciTEvent e = tl->upper_bound(s->tick); e != tl->end(); ++e) {
+                  if (e->first >= s->tick + s->len)
+                        break;
+                  rt.utick = e->first + offset;
+                  rt.tick  = e->first;
+                  rt.time  = e->second.time + s->timeOffset;
+                  rt.tempo = e->second.tempo * rel;
+                  t->time.append(rt);
+                  }
+            }
+
+      //
+      // tick2utick returns the first playback of a score tick;
+      // split the score into intervals at segment boundaries
+      // and remember the first segment playing each interval
+      //
+      QVector<int>& ts = t->tickStart;
+      foreach(const RepeatSegment* s, *this) {
+            ts.append(s->tick);
+            ts.append(s->tick + s->len);
+            }
+      qSort(ts);
+      ts.erase(std::unique(ts.begin(), ts.end()), ts.end());
+      t->tickOffset.fill(INT_MIN, ts.size());
+      foreach(const RepeatSegment* s, *this) {
+            int k = qLowerBound(ts, s->tick) - ts.begin();
+            for (; ts[k] < s->tick + s->len; ++k) {
+                  if (t->tickOffset[k] == INT_MIN)
+                        t->tickOffset[k] = s->utick - s->tick;
+                  }
+            }
+      t->tempoSN = tl->tempoSN();
+      return t;
+      }
+
+//---------------------------------------------------------
+//   utickLessThan
+//---------------------------------------------------------
+
+static bool utickLessThan(int utick, const RepeatTime& rt)
+      {
+      return utick < rt.utick;
+      }
+
+//---------------------------------------------------------
+//   timeLessThan
+//---------------------------------------------------------
+
+static bool timeLessThan(qreal time, const RepeatTime& rt)
+      {
+      return time < rt.time;
+      }
+
 //---------------------------------------------------------
 //   utick2tick
 //---------------------------------------------------------
 
 int RepeatList::utick2tick(int tick) const
       {
-      unsigned n = size();
-      if (n == 0)
+      const RepeatTimeTable* t = _table;
+      if (!t || t->time.isEmpty())
             return tick;
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  idx1 = i;
-                  return tick - (at(i)->utick - at(i)->tick);
-                  }
+      QVector<RepeatTime>::const_iterator i = std::upper_bound(t->time.begin(),
+         t->time.end(), tick, utickLessThan);
+      if (i != t->time.begin()) {
+            --i;
+            return tick - (i->utick - i->tick);
             }
       if (MScore::debugMode) {
             qDebug("utick %d not found in RepeatList\n", tick);
@@ -184,11 +355,13 @@ int RepeatList::utick2tick(int tick) const
 
 int RepeatList::tick2utick(int tick) const
       {
-      foreach (const RepeatSegment* s, *this) {
-            if (tick >= s->tick && tick < (s->tick + s->len))
-                  return s->utick + (tick - s->tick);
-            }
-      return 0;
+      const RepeatTimeTable* t = _table;
+      if (!t)
+            return 0;
+      int k = qUpperBound(t->tickStart, tick) - t->tickStart.begin() - 1;
+      if (k < 0 || k >= t->tickOffset.size() || t->tickOffset[k] == INT_MIN)
+            return 0;
+      return tick + t->tickOffset[k];
       }
 
 //---------------------------------------------------------
@@ -197,34 +370,34 @@ int RepeatList::tick2utick(int tick) const
 
 qreal RepeatList::utick2utime(int tick) const
       {
-      unsigned n = size();
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  int t     = tick - (at(i)->utick - at(i)->tick);
-                  qreal tt = _score->tempomap()->tick2time(t) + at(i)->timeOffset;
-                  return tt;
-                  }
-            }
-      return 0.0;
+      const RepeatTimeTable* t = _table;
+      if (!t)
+            return 0.0;
+      QVector<RepeatTime>::const_iterator i = std::upper_bound(t->time.begin(),
+         t->time.end(), tick, utickLessThan);
+      if (i == t->time.begin())
+            return 0.0;
+      --i;
+      return i->time + qreal(tick - i->utick) / i->tempo;
       }
 
 //---------------------------------------------------------
 //   utime2utick
 //---------------------------------------------------------
 
-int RepeatList::utime2utick(qreal t) const
+int RepeatList::utime2utick(qreal time) const
       {
-      unsigned n = size();
-      unsigned ii = (idx2 < n) && (t >= at(idx2)->utime) ? idx2 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((t >= at(i)->utime) && ((i + 1 == n) || (t < at(i+1)->utime))) {
-                  idx2 = i;
-                  return _score->tempomap()->time2tick(t - at(i)->timeOffset) + (at(i)->utick - at(i)->tick);
-                  }
+      const RepeatTimeTable* t = _table;
+      if (!t)
+            return 0;
+      QVector<RepeatTime>::const_iterator i = std::upper_bound(t->time.begin(),
+         t->time.end(), time, timeLessThan);
+      if (i != t->time.begin()) {
+            --i;
+            return i->utick + lrint((time - i->time) * i->tempo);
             }
       if (MScore::debugMode) {
-            qDebug("time %f not found in RepeatList\n", t);
+            qDebug("time %f not found in RepeatList\n", time);
             abort();
             }
       return 0;
@@ -32,21 +32,62 @@ class RepeatSegment {
       RepeatSegment();
       };
 
+//---------------------------------------------------------
+//   RepeatTime
+//    breakpoint of the piecewise linear mapping between
+//    unrolled ticks and time; there is one breakpoint at
+//    the start of every repeat segment and at every tempo
+//    change inside a segment
+//---------------------------------------------------------
+
+struct RepeatTime {
+      int utick;
+      int tick;
+      qreal time;       // unrolled time in seconds
+      qreal tempo;      // ticks per second, relative tempo applied
+      };
+
+//---------------------------------------------------------
+//   RepeatTimeTable
+//    repeat segments and tempo map flattened into binary
+//    searchable tables; never changed once published
+//---------------------------------------------------------
+
+struct RepeatTimeTable {
+      QVector<RepeatTime> time;     // sorted by utick and by time
+      QVector<int> tickStart;       // sorted score tick intervals
+      QVector<int> tickOffset;      // utick - tick of first playback of interval
+      int tempoSN;                  // tempo map serial
+      int serial;                   // tables are numbered in creation order
+      };
+
 //---------------------------------------------------------
 //   RepeatList
+//    The time table is built in the gui thread and
+//    published by swapping a pointer; lookups are read
+//    only and may run in the audio thread.
 //---------------------------------------------------------
 
 class RepeatList: public QList<RepeatSegment*>
       {
       Score* _score;
-      mutable unsigned idx1, idx2;   // cached values
+
+      QAtomicPointer<RepeatTimeTable> _table;     // current table
+      QAtomicPointer<RepeatTimeTable> _staged;    // installed by commitTimeTable()
+      QList<RepeatTimeTable*> _tables;            // all tables, oldest first
+      int _serial;                                // serial of the last table created
+      QAtomicInt _acked;                          // see ackTimeTable()
 
       RepeatSegment* rs;            // tmp value during unwind()
 
       Measure* jumpToStartRepeat(Measure*);
+      void updateTimes();
+      RepeatTimeTable* createTimeTable() const;
+      void addTimeTable(RepeatTimeTable*);
 
    public:
       RepeatList(Score* s);
+      ~RepeatList();
       void unwind();
       int utick2tick(int tick) const;
       int tick2utick(int tick) const;
@@ -54,6 +95,10 @@ class RepeatList: public QList<RepeatSegment*>
       int utime2utick(qreal) const;
       qreal utick2utime(int) const;
       void update();
+      void stageUpdate();
+      void commitTimeTable();
+      void ackTimeTable();
+      bool timeTableValid() const;
       int ticks();
       };
 
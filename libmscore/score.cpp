@@ -90,9 +90,10 @@ bool showRubberBand  = true;
 
 MeasureBaseList::MeasureBaseList()
       {
-      _first = 0;
-      _last  = 0;
-      _size  = 0;
+      _first  = 0;
+      _last   = 0;
+      _size   = 0;
+      _serial = 0;
       };
 
 //---------------------------------------------------------
@@ -101,6 +102,7 @@ MeasureBaseList::MeasureBaseList()
 
 void MeasureBaseList::push_back(MeasureBase* e)
       {
+      ++_serial;
       ++_size;
       if (_last) {
             _last->setNext(e);
@@ -121,6 +123,7 @@ void MeasureBaseList::push_back(MeasureBase* e)
 
 void MeasureBaseList::push_front(MeasureBase* e)
       {
+      ++_serial;
       ++_size;
       if (_first) {
             _first->setPrev(e);
@@ -142,6 +145,7 @@ void MeasureBaseList::push_front(MeasureBase* e)
 
 void MeasureBaseList::add(MeasureBase* e)
       {
+      ++_serial;
       MeasureBase* el = e->next();
       if (el == 0) {
             push_back(e);
@@ -163,6 +167,7 @@ void MeasureBaseList::add(MeasureBase* e)
 
 void MeasureBaseList::remove(MeasureBase* el)
       {
+      ++_serial;
       --_size;
       if (el->prev())
             el->prev()->setNext(el->next());
@@ -180,6 +185,7 @@ void MeasureBaseList::remove(MeasureBase* el)
 
 void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
       {
+      ++_serial;
       ++_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             ++_size;
@@ -221,6 +227,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
       {
+      ++_serial;
       --_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             --_size;
@@ -242,6 +249,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
       {
+      ++_serial;
       nb->setPrev(ob->prev());
       nb->setNext(ob->next());
       if (ob->prev())
@@ -297,6 +305,7 @@ void Score::init()
       _symIdx         = 0;
       _pageNumberOffset = 0;
       startLayout     = 0;
+      _tickIndexSerial = -1;
       _undo           = new UndoStack();
       _repeatList     = new RepeatList(this);
       foreach (StaffType* st, ::staffTypes)
@@ -307,6 +316,8 @@ void Score::init()
 
       _updateAll      = true;
       _layoutAll      = true;
+      _layoutDeferred = false;
+      _viewersPending = false;
       layoutFlags     = 0;
       _undoRedo       = false;
       _playNote       = false;
@@ -324,6 +335,7 @@ void Score::init()
 
       _printing       = false;
       _playlistDirty  = false;
+      _renderSerial   = 0;
       _autosaveDirty  = false;
       _dirty          = false;
       _saved          = false;
@@ -481,6 +493,7 @@ void Score::addMeasure(MeasureBase* m, MeasureBase* pos)
 
 void Score::fixTicks()
       {
+      _tickIndexSerial = -1;        // rebuild tick index on next use
       int number = 0;
       int tick   = 0;
       Measure* fm = firstMeasure();
@@ -749,6 +762,20 @@ void Score::setDirty(bool val)
             }
       }
 
+//---------------------------------------------------------
+//   setPlaylistDirty
+//    a dirty playlist is rendered again from scratch,
+//    cached measure events are dropped too
+//---------------------------------------------------------
+
+void Score::setPlaylistDirty(bool val)
+      {
+      if (val)
+            setPlaybackDirty();
+      else
+            _playlistDirty = false;
+      }
+
 //---------------------------------------------------------
 //   playlistDirty
 //---------------------------------------------------------
@@ -923,14 +950,51 @@ void Score::setInputTrack(int v)
 
 void Score::setLayout(Measure* m)
       {
-      if (m)
+      if (m) {
             m->setDirty();
-      if (startLayout && startLayout != m)
+            // startLayout stands for the whole system, the
+            // midi events are cached per measure
+            setPlaybackDirty(m);
+            }
+      // doReLayout() lays out the whole system of startLayout
+      if (startLayout && startLayout != m
+         && (m == 0 || m->system() == 0 || m->system() != startLayout->system()))
             setLayoutAll(true);
-      else
+      else if (startLayout == 0)
             startLayout = m;
       }
 
+//---------------------------------------------------------
+//   setLayoutFor
+//    e was added or removed; elements of a chord or rest
+//    only change the layout of their measure, all others
+//    can change the layout of the whole score
+//---------------------------------------------------------
+
+void Score::setLayoutFor(Element* e)
+      {
+      switch (e->type()) {
+            case Element::NOTE:
+            case Element::CHORD:
+            case Element::REST:
+            case Element::ACCIDENTAL:
+            case Element::ARTICULATION:
+            case Element::ARPEGGIO:
+            case Element::FINGERING:
+            case Element::STAFF_TEXT:
+                  for (Element* p = e->parent(); p; p = p->parent()) {
+                        if (p->type() == Element::MEASURE) {
+                              setLayout(static_cast<Measure*>(p));
+                              return;
+                              }
+                        }
+                  break;
+            default:
+                  break;
+            }
+      setLayoutAll(true);
+      }
+
 //---------------------------------------------------------
 //   appendPart
 //---------------------------------------------------------
@@ -1358,8 +1422,13 @@ void Score::addElement(Element* element)
                this, element, element->name(), element->parent(),
                element->parent() ? element->parent()->name() : "");
             }
-      if (element->parent() && element->parent()->type() == Element::SEGMENT)
-            static_cast<Segment*>(element->parent())->measure()->setDirty();
+      if (element->parent() && element->parent()->type() == Element::SEGMENT) {
+            Segment* s = static_cast<Segment*>(element->parent());
+            if (element->generated())
+                  s->measure()->setHeaderDirty(s);
+            else
+                  s->measure()->setDirty();
+            }
 
       Element::ElementType et = element->type();
       if (et == Element::TREMOLO) {
@@ -1431,13 +1500,13 @@ void Score::addElement(Element* element)
                         s->pitchOffsets().setPitchOffset(tick, 0);
                         }
                   layoutFlags |= LAYOUT_FIX_PITCH_VELO;
-                  _playlistDirty = true;
+                  setPlaybackDirty();
                   }
                   break;
 
             case Element::DYNAMIC:
                   layoutFlags |= LAYOUT_FIX_PITCH_VELO;
-                  _playlistDirty = true;
+                  setPlaybackDirty();
                   break;
             case Element::CLEF:
                   {
@@ -1487,7 +1556,7 @@ void Score::addElement(Element* element)
             default:
                   break;
             }
-      setLayoutAll(true);
+      setLayoutFor(element);
       }
 
 //---------------------------------------------------------
@@ -1507,8 +1576,13 @@ void Score::removeElement(Element* element)
             qDebug("   Score(%p)::removeElement %p(%s) parent %p(%s)",
                this, element, element->name(), parent, parent ? parent->name() : "");
             }
-      if (element->parent() && element->parent()->type() == Element::SEGMENT)
-            static_cast<Segment*>(element->parent())->measure()->setDirty();
+      if (element->parent() && element->parent()->type() == Element::SEGMENT) {
+            Segment* s = static_cast<Segment*>(element->parent());
+            if (element->generated())
+                  s->measure()->setHeaderDirty(s);
+            else
+                  s->measure()->setDirty();
+            }
 
       // special for MEASURE, HBOX, VBOX
       // their parent is not static
@@ -1580,13 +1654,13 @@ void Score::removeElement(Element* element)
                   s->pitchOffsets().remove(tick1);
                   s->pitchOffsets().remove(tick2);
                   layoutFlags |= LAYOUT_FIX_PITCH_VELO;
-                  _playlistDirty = true;
+                  setPlaybackDirty();
                   }
                   break;
 
             case Element::DYNAMIC:
                   layoutFlags |= LAYOUT_FIX_PITCH_VELO;
-                  _playlistDirty = true;
+                  setPlaybackDirty();
                   break;
 
             case Element::CHORD:
@@ -1632,7 +1706,7 @@ void Score::removeElement(Element* element)
             default:
                   break;
             }
-      setLayoutAll(true);
+      setLayoutFor(element);
       }
 
 //---------------------------------------------------------
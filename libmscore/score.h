@@ -59,6 +59,7 @@ class Volta;
 class MidiEvent;
 class Excerpt;
 class EventMap;
+class PlayEvent;
 class Harmony;
 struct Channel;
 class Tuplet;
@@ -131,6 +132,7 @@ class MeasureBaseList {
       int _size;
       MeasureBase* _first;
       MeasureBase* _last;
+      int _serial;            ///< incremented on every change of the list
 
       void push_back(MeasureBase* e);
       void push_front(MeasureBase* e);
@@ -139,13 +141,14 @@ class MeasureBaseList {
       MeasureBaseList();
       MeasureBase* first() const { return _first; }
       MeasureBase* last()  const { return _last; }
-      void clear()               { _first = _last = 0; _size = 0; }
+      void clear()               { _first = _last = 0; _size = 0; ++_serial; }
       void add(MeasureBase*);
       void remove(MeasureBase*);
       void insert(MeasureBase*, MeasureBase*);
       void remove(MeasureBase*, MeasureBase*);
       void change(MeasureBase* o, MeasureBase* n);
       int size() const { return _size; }
+      int serial() const { return _serial; }
       };
 
 //---------------------------------------------------------
@@ -262,6 +265,8 @@ class Score : public QObject {
       int _pageNumberOffset;        ///< Offset for page numbers.
 
       MeasureBaseList _measures;          // here are the notes
+      mutable QVector<Measure*> _tickIndex; ///< measures sorted by tick, used by tick2measure()
+      mutable int _tickIndexSerial;         ///< _measures.serial() when _tickIndex was build
       //
       // generated objects during layout:
       //
@@ -302,6 +307,8 @@ class Score : public QObject {
 
       bool _updateAll;
       bool _layoutAll;        ///< do a complete relayout
+      bool _layoutDeferred;   ///< part score not laid out until viewed or exported
+      bool _viewersPending;   ///< layout changed in a worker thread, viewers not told yet
 
       bool _undoRedo;         ///< true if in processing a undo/redo
       bool _playNote;         ///< play selected note after command
@@ -319,6 +326,7 @@ class Score : public QObject {
 
       bool _printing;   ///< True if we are drawing to a printer
       bool _playlistDirty;
+      int _renderSerial;      ///< incremented to invalidate all cached measure midi events
       bool _autosaveDirty;
       bool _dirty;      ///< Score data was modified.
       bool _saved;      ///< True if project was already saved; only on first
@@ -406,9 +414,12 @@ class Score : public QObject {
       System* getNextSystem(bool, bool);
       bool doReLayout();
       Measure* skipEmptyMeasures(Measure*, System*);
+      qreal systemMeasureWidth(Measure*, bool isFirstMeasure);
+      bool systemBreakAfter(Measure*, int measures) const;
 
-      void layoutStage2();
-      void layoutStage3();
+      void layoutStage2(Measure* fm = 0, Measure* lm = 0);
+      void layoutStage3(Measure* fm = 0, Measure* lm = 0);
+      void placeElements(Segment* fs, Measure* em);
       void transposeKeys(int staffStart, int staffEnd, int tickStart, int tickEnd, const Interval&);
       void reLayout(Measure*);
 
@@ -424,7 +435,9 @@ class Score : public QObject {
       void init();
       void removeGeneratedElements(Measure* mb, Measure* end);
       qreal cautionaryWidth(Measure* m);
-      void createPlayEvents();
+      void createPlayEvents(bool dirtyOnly = false);
+      void layoutScores(void (*layout)(Score*));
+      void notifyViewers();
 
    public:
       void setDirty(bool val);
@@ -559,6 +572,8 @@ class Score : public QObject {
       void end1();
       void end2();
       void update();
+      void doDeferredLayout();
+      void flushViewers();
 
       void cmdRemoveTimeSig(TimeSig*);
       void cmdAddTimeSig(Measure*, int staffIdx, TimeSig*, bool local);
@@ -613,6 +628,7 @@ class Score : public QObject {
       void setSelection(const Selection& s);
 
       int pos();
+      const QVector<Measure*>& tickIndex() const;
       Measure* tick2measure(int tick) const;
       MeasureBase* tick2measureBase(int tick) const;
       Segment* tick2segment(int tick, bool first = false, Segment::SegmentTypes st = Segment::SegAll) const;
@@ -621,7 +637,7 @@ class Score : public QObject {
       void addArticulation(Element*, Articulation* atr);
 
       bool playlistDirty();
-      void setPlaylistDirty(bool val) { _playlistDirty = val; }
+      void setPlaylistDirty(bool val);
 
       void cmd(const QAction*);
       int fileDivision(int t) const { return (t * MScore::division + _fileDivision/2) / _fileDivision; }
@@ -681,6 +697,10 @@ class Score : public QObject {
       void pasteStaff(XmlReader&, ChordRest* dst);
       void renderMidi(EventMap* events);
       void renderPart(EventMap* events, Part*);
+      const QVector<PlayEvent>& renderMeasure(Measure*, Part*);
+      int renderSerial() const  { return _renderSerial; }
+      void setPlaybackDirty();
+      void setPlaybackDirty(Measure*);
       int mscVersion() const    { return _mscVersion; }
       void setMscVersion(int v) { _mscVersion = v; }
 
@@ -690,6 +710,7 @@ class Score : public QObject {
       const QList<Excerpt*>& excerpts() const { return _excerpts; }
 
       void setLayout(Measure* m);
+      void setLayoutFor(Element*);
 
       int midiPort(int idx) const;
       int midiChannel(int idx) const;
@@ -160,8 +160,10 @@ void Score::write(Xml& xml, bool selectionOnly)
       xml.curTrack = -1;
       if (!selectionOnly) {
             foreach(Excerpt* excerpt, _excerpts) {
-                  if (excerpt->score() != this)
+                  if (excerpt->score() != this) {
+                        excerpt->score()->doDeferredLayout();
                         excerpt->score()->write(xml, false);       // recursion
+                        }
                   }
             }
       if (parentScore())
@@ -776,174 +778,209 @@ bool Score::read(XmlReader& e)
 
       while (e.readNextStartElement()) {
             e.setTrack(-1);
-            const QStringRef& tag(e.name());
-            if (tag == "Staff")
-                  readStaff(e);
-            else if (tag == "KeySig") {
-                  KeySig* ks = new KeySig(this);
-                  ks->read(e);
-                  customKeysigs.append(ks);
-                  }
-            else if (tag == "StaffType") {
-                  int idx        = e.intAttribute("idx");
-                  StaffType* ost = staffType(idx);
-                  StaffType* st;
-                  if (ost)
-                        st = ost->clone();
-                  else {
-                        QString group  = e.attribute("group", "pitched");
-                        if (group == "percussion")
-                              st  = new StaffTypePercussion();
-                        else if (group == "tablature")
-                              st  = new StaffTypeTablature();
-                        else
-                              st  = new StaffTypePitched();
+            switch (e.tag()) {
+                  case TAG_Staff:
+                        readStaff(e);
+                        break;
+                  case TAG_KeySig: {
+                        KeySig* ks = new KeySig(this);
+                        ks->read(e);
+                        customKeysigs.append(ks);
                         }
-                  st->read(e);
-                  st->setBuildin(false);
-                  addStaffType(idx, st);
-                  }
-            else if (tag == "siglist")
-                  _sigmap->read(e, _fileDivision);
-            else if (tag == "programVersion") {
-                  _mscoreVersion = e.readElementText();
-                  parseVersion(_mscoreVersion);
-                  }
-            else if (tag == "programRevision")
-                  _mscoreRevision = e.readInt();
-            else if (tag == "Omr") {
+                        break;
+                  case TAG_StaffType: {
+                        int idx        = e.intAttribute("idx");
+                        StaffType* ost = staffType(idx);
+                        StaffType* st;
+                        if (ost)
+                              st = ost->clone();
+                        else {
+                              QString group  = e.attribute("group", "pitched");
+                              if (group == "percussion")
+                                    st  = new StaffTypePercussion();
+                              else if (group == "tablature")
+                                    st  = new StaffTypeTablature();
+                              else
+                                    st  = new StaffTypePitched();
+                              }
+                        st->read(e);
+                        st->setBuildin(false);
+                        addStaffType(idx, st);
+                        }
+                        break;
+                  case TAG_siglist:
+                        _sigmap->read(e, _fileDivision);
+                        break;
+                  case TAG_programVersion:
+                        _mscoreVersion = e.readElementText();
+                        parseVersion(_mscoreVersion);
+                        break;
+                  case TAG_programRevision:
+                        _mscoreRevision = e.readInt();
+                        break;
+                  case TAG_Omr:
 #ifdef OMR
-                  _omr = new Omr(this);
-                  _omr->read(e);
+                        _omr = new Omr(this);
+                        _omr->read(e);
 #endif
-                  }
-            else if (tag == "Audio") {
-                  _audio = new Audio;
-                  _audio->read(e);
-                  }
-            else if (tag == "showOmr")
-                  _showOmr = e.readInt();
-            else if (tag == "playMode")
-                  _playMode = PlayMode(e.readInt());
-            else if (tag == "LayerTag") {
-                  int id = e.intAttribute("id");
-                  const QString& tag = e.attribute("tag");
-                  QString val(e.readElementText());
-                  if (id >= 0 && id < 32) {
-                        _layerTags[id] = tag;
-                        _layerTagComments[id] = val;
+                        break;
+                  case TAG_Audio:
+                        _audio = new Audio;
+                        _audio->read(e);
+                        break;
+                  case TAG_showOmr:
+                        _showOmr = e.readInt();
+                        break;
+                  case TAG_playMode:
+                        _playMode = PlayMode(e.readInt());
+                        break;
+                  case TAG_LayerTag: {
+                        int id = e.intAttribute("id");
+                        const QString& tag = e.attribute("tag");
+                        QString val(e.readElementText());
+                        if (id >= 0 && id < 32) {
+                              _layerTags[id] = tag;
+                              _layerTagComments[id] = val;
+                              }
                         }
-                  }
-            else if (tag == "Layer") {
-                  Layer layer;
-                  layer.name = e.attribute("name");
-                  layer.tags = e.attribute("mask").toUInt();
-                  _layer.append(layer);
-                  }
-            else if (tag == "currentLayer")
-                  _currentLayer = e.readInt();
-            else if (tag == "SyntiSettings") {
-                  _syntiState.clear();
-                  _syntiState.read(e);
-                  }
-            else if (tag == "Spatium")
-                  _style.setSpatium (e.readDouble() * MScore::DPMM); // obsolete, moved to Style
-            else if (tag == "page-offset")            // obsolete, moved to Score
-                  setPageNumberOffset(e.readInt());
-            else if (tag == "Division")
-                  _fileDivision = e.readInt();
-            else if (tag == "showInvisible")
-                  _showInvisible = e.readInt();
-            else if (tag == "showUnprintable")
-                  _showUnprintable = e.readInt();
-            else if (tag == "showFrames")
-                  _showFrames = e.readInt();
-            else if (tag == "showMargins")
-                  _showPageborders = e.readInt();
-            else if (tag == "Style") {
-                  qreal sp = _style.spatium();
-                  _style.load(e);
-                  // if (_layoutMode == LayoutFloat || _layoutMode == LayoutSystem) {
-                  if (_layoutMode == LayoutFloat) {
-                        // style should not change spatium in
-                        // float mode
-                        _style.setSpatium(sp);
+                        break;
+                  case TAG_Layer: {
+                        Layer layer;
+                        layer.name = e.attribute("name");
+                        layer.tags = e.attribute("mask").toUInt();
+                        _layer.append(layer);
                         }
-                  }
-            else if (tag == "copyright" || tag == "rights") {
-                  Text* text = new Text(this);
-                  text->read(e);
-                  setMetaTag("copyright", text->getText());
-                  delete text;
-                  }
-            else if (tag == "movement-number")
-                  setMetaTag("movementNumber", e.readElementText());
-            else if (tag == "movement-title")
-                  setMetaTag("movementTitle", e.readElementText());
-            else if (tag == "work-number")
-                  setMetaTag("workNumber", e.readElementText());
-            else if (tag == "work-title")
-                  setMetaTag("workTitle", e.readElementText());
-            else if (tag == "source")
-                  setMetaTag("source", e.readElementText());
-            else if (tag == "metaTag") {
-                  QString name = e.attribute("name");
-                  setMetaTag(name, e.readElementText());
-                  }
-            else if (tag == "Part") {
-                  Part* part = new Part(this);
-                  part->read(e);
-                  _parts.push_back(part);
-                  }
-            else if (tag == "Slur") {
-                  Slur* slur = new Slur(this);
-                  slur->read(e);
-                  e.addSpanner(slur);
-                  }
-            else if (tag == "Excerpt") {
-                  Excerpt* ex = new Excerpt(this);
-                  ex->read(e);
-                  _excerpts.append(ex);
-                  }
-            else if (tag == "Beam") {
-                  Beam* beam = new Beam(this);
-                  beam->read(e);
-                  beam->setParent(0);
-                  // _beams.append(beam);
-                  }
-            else if (tag == "Score") {          // recursion
-                  Score* s = new Score(style());
-                  s->setParentScore(this);
-                  s->read(e);
-                  addExcerpt(s);
-                  }
-            else if (tag == "PageList") {
-                  while (e.readNextStartElement()) {
-                        if (e.name() == "Page") {
-                              Page* page = new Page(this);
-                              _pages.append(page);
-                              page->read(e);
+                        break;
+                  case TAG_currentLayer:
+                        _currentLayer = e.readInt();
+                        break;
+                  case TAG_SyntiSettings:
+                        _syntiState.clear();
+                        _syntiState.read(e);
+                        break;
+                  case TAG_Spatium:
+                        _style.setSpatium (e.readDouble() * MScore::DPMM); // obsolete, moved to Style
+                        break;
+                  case TAG_page_offset:                // obsolete, moved to Score
+                        setPageNumberOffset(e.readInt());
+                        break;
+                  case TAG_Division:
+                        _fileDivision = e.readInt();
+                        break;
+                  case TAG_showInvisible:
+                        _showInvisible = e.readInt();
+                        break;
+                  case TAG_showUnprintable:
+                        _showUnprintable = e.readInt();
+                        break;
+                  case TAG_showFrames:
+                        _showFrames = e.readInt();
+                        break;
+                  case TAG_showMargins:
+                        _showPageborders = e.readInt();
+                        break;
+                  case TAG_Style: {
+                        qreal sp = _style.spatium();
+                        _style.load(e);
+                        // if (_layoutMode == LayoutFloat || _layoutMode == LayoutSystem) {
+                        if (_layoutMode == LayoutFloat) {
+                              // style should not change spatium in
+                              // float mode
+                              _style.setSpatium(sp);
                               }
-                        else
-                              e.unknown();
                         }
-                  }
-            else if (tag == "name")
-                  setName(e.readElementText());
-            else if (tag == "page-layout") {    // obsolete
-                  if (_layoutMode != LayoutFloat && _layoutMode != LayoutSystem) {
-                        PageFormat pf;
-                        pf.copy(*pageFormat());
-                        pf.read(e);
-                        setPageFormat(pf);
+                        break;
+                  case TAG_copyright:
+                  case TAG_rights: {
+                        Text* text = new Text(this);
+                        text->read(e);
+                        setMetaTag("copyright", text->getText());
+                        delete text;
                         }
-                  else
+                        break;
+                  case TAG_movement_number:
+                        setMetaTag("movementNumber", e.readElementText());
+                        break;
+                  case TAG_movement_title:
+                        setMetaTag("movementTitle", e.readElementText());
+                        break;
+                  case TAG_work_number:
+                        setMetaTag("workNumber", e.readElementText());
+                        break;
+                  case TAG_work_title:
+                        setMetaTag("workTitle", e.readElementText());
+                        break;
+                  case TAG_source:
+                        setMetaTag("source", e.readElementText());
+                        break;
+                  case TAG_metaTag: {
+                        QString name = e.attribute("name");
+                        setMetaTag(name, e.readElementText());
+                        }
+                        break;
+                  case TAG_Part: {
+                        Part* part = new Part(this);
+                        part->read(e);
+                        _parts.push_back(part);
+                        }
+                        break;
+                  case TAG_Slur: {
+                        Slur* slur = new Slur(this);
+                        slur->read(e);
+                        e.addSpanner(slur);
+                        }
+                        break;
+                  case TAG_Excerpt: {
+                        Excerpt* ex = new Excerpt(this);
+                        ex->read(e);
+                        _excerpts.append(ex);
+                        }
+                        break;
+                  case TAG_Beam: {
+                        Beam* beam = new Beam(this);
+                        beam->read(e);
+                        beam->setParent(0);
+                        // _beams.append(beam);
+                        }
+                        break;
+                  case TAG_Score: {          // recursion
+                        Score* s = new Score(style());
+                        s->setParentScore(this);
+                        s->read(e);
+                        addExcerpt(s);
+                        }
+                        break;
+                  case TAG_PageList:
+                        while (e.readNextStartElement()) {
+                              if (e.name() == "Page") {
+                                    Page* page = new Page(this);
+                                    _pages.append(page);
+                                    page->read(e);
+                                    }
+                              else
+                                    e.unknown();
+                              }
+                        break;
+                  case TAG_name:
+                        setName(e.readElementText());
+                        break;
+                  case TAG_page_layout:    // obsolete
+                        if (_layoutMode != LayoutFloat && _layoutMode != LayoutSystem) {
+                              PageFormat pf;
+                              pf.copy(*pageFormat());
+                              pf.read(e);
+                              setPageFormat(pf);
+                              }
+                        else
+                              e.skipCurrentElement();
+                        break;
+                  case TAG_cursorTrack:
                         e.skipCurrentElement();
+                        break;
+                  default:
+                        e.unknown();
+                        break;
                   }
-            else if (tag == "cursorTrack")
-                  e.skipCurrentElement();
-            else
-                  e.unknown();
             }
 
       // check slurs
@@ -795,13 +795,13 @@ void Segment::write(Xml& xml) const
 void Segment::read(XmlReader& e)
       {
       while (e.readNextStartElement()) {
-            const QStringRef& tag(e.name());
+            const XmlTag tag = e.tag();
 
-            if (tag == "subtype")
+            if (tag == TAG_subtype)
                   _subtype = SegmentType(e.readInt());
-            else if (tag == "leadingSpace")
+            else if (tag == TAG_leadingSpace)
                   _extraLeadingSpace = Spatium(e.readDouble());
-            else if (tag == "trailingSpace")
+            else if (tag == TAG_trailingSpace)
                   _extraTrailingSpace = Spatium(e.readDouble());
             else
                   e.unknown();
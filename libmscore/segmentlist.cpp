@@ -78,6 +78,7 @@ void SegmentList::check()
 
 void SegmentList::insert(Segment* e, Segment* el)
       {
+      _indexValid = false;
       if (e->score()->undoRedo())
             qFatal("SegmentList:insert in undo/redo");
       if (el == 0)
@@ -100,6 +101,7 @@ void SegmentList::insert(Segment* e, Segment* el)
 
 void SegmentList::remove(Segment* el)
       {
+      _indexValid = false;
       if (el->score()->undoRedo())
             qFatal("SegmentList:remove in undo/redo");
       --_size;
@@ -128,6 +130,7 @@ void SegmentList::remove(Segment* el)
 
 void SegmentList::push_back(Segment* e)
       {
+      _indexValid = false;
       ++_size;
       e->setNext(0);
       if (_last)
@@ -145,6 +148,7 @@ void SegmentList::push_back(Segment* e)
 
 void SegmentList::push_front(Segment* e)
       {
+      _indexValid = false;
       ++_size;
       e->setPrev(0);
       if (_first)
@@ -162,6 +166,7 @@ void SegmentList::push_front(Segment* e)
 
 void SegmentList::insert(Segment* seg)
       {
+      _indexValid = false;
 #ifndef NDEBUG
 //      qDebug("insertSeg <%s> %p %p %p", seg->subTypeName(), seg->prev(), seg, seg->next());
       check();
@@ -226,4 +231,31 @@ Segment* SegmentList::first(Segment::SegmentTypes types) const
       return 0;
       }
 
+//---------------------------------------------------------
+//   lowerBound
+///   Return the first segment with a relative tick
+///   position >= \a rtick or 0 if there is none.
+///   Uses binary search on an index which is rebuild
+///   after the list was changed.
+//---------------------------------------------------------
 
+Segment* SegmentList::lowerBound(int rtick) const
+      {
+      if (!_indexValid) {
+            _index.clear();
+            _index.reserve(_size);
+            for (Segment* s = _first; s; s = s->next())
+                  _index.append(s);
+            _indexValid = true;
+            }
+      int lo = 0;
+      int hi = _index.size();
+      while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (_index[mid]->rtick() < rtick)
+                  lo = mid + 1;
+            else
+                  hi = mid;
+            }
+      return lo < _index.size() ? _index[lo] : 0;
+      }
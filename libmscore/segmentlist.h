@@ -24,10 +24,12 @@ class SegmentList {
       Segment* _first;        ///< First item of segment list
       Segment* _last;         ///< Last item of segment list
       int _size;              ///< Number of items in segment list
+      mutable QVector<Segment*> _index;   ///< segments in list order, see lowerBound()
+      mutable bool _indexValid;
 
    public:
       SegmentList()                        { clear(); }
-      void clear()                         { _first = _last = 0; _size = 0; }
+      void clear()                         { _first = _last = 0; _size = 0; _indexValid = false; }
 #ifndef NDEBUG
       void check();
 #else
@@ -41,6 +43,7 @@ class SegmentList {
 
       Segment* last() const                { return _last;        }
       Segment* firstCRSegment() const;
+      Segment* lowerBound(int rtick) const;
       void remove(Segment*);
       void push_back(Segment*);
       void push_front(Segment*);
@@ -23,7 +23,6 @@ static bool symbolsInitialized[2] = { false, false };
 
 QMap<const char*, SymCode*> charReplaceMap;
 
-static QReadWriteLock gLock;
 QHash<QString, SymId> Sym::lnhash;
 QVector<const char*> Sym::symNames;
 QVector<QString> Sym::symUserNames;
@@ -355,18 +354,73 @@ QFont fontId2font(int fontId)
 
 #ifdef USE_GLYPHS
 //---------------------------------------------------------
-//   genGlyphs
+//   GlyphKey
+//    a run of n equal glyphs of one symbol
 //---------------------------------------------------------
 
-void Sym::genGlyphs(const QFont& font)
+struct GlyphKey {
+      int fontId;
+      int code;
+      int n;
+      qreal advance;
+      GlyphKey(int f, int c, int cnt, qreal a) : fontId(f), code(c), n(cnt), advance(a) {}
+      bool operator==(const GlyphKey& k) const {
+            return fontId == k.fontId && code == k.code && n == k.n && advance == k.advance;
+            }
+      };
+
+inline uint qHash(const GlyphKey& k)
+      {
+      return (uint(k.code) * 31 + uint(k.n)) * 4 + uint(k.fontId);
+      }
+
+//---------------------------------------------------------
+//   GlyphCache
+//    QRawFont is bound to the thread which created it,
+//    so every painting thread builds its own raw fonts and
+//    glyph runs. Runs are immutable once created and
+//    need no locking.
+//---------------------------------------------------------
+
+struct GlyphCache {
+      QRawFont fonts[4];
+      QHash<GlyphKey, QGlyphRun> runs;
+      };
+
+static QThreadStorage<GlyphCache*> glyphCache;
+
+//---------------------------------------------------------
+//   glyphRun
+//    return the cached run of n glyphs for this symbol
+//---------------------------------------------------------
+
+const QGlyphRun& Sym::glyphRun(int n) const
       {
-      QRawFont rfont = QRawFont::fromFont(font);
+      GlyphCache* cache = glyphCache.localData();
+      if (cache == 0) {
+            cache = new GlyphCache;
+            glyphCache.setLocalData(cache);
+            }
+      GlyphKey key(fontId, _code, n, w);
+      QHash<GlyphKey, QGlyphRun>::const_iterator i = cache->runs.constFind(key);
+      if (i != cache->runs.constEnd())
+            return i.value();
+
+      QRawFont& rfont = cache->fonts[fontId];
+      if (!rfont.isValid())
+            rfont = QRawFont::fromFont(fontId2font(fontId));
       QVector<quint32> idx = rfont.glyphIndexesForString(toString());
-      QVector<QPointF> adv;
-      adv << QPointF();
-      glyphs.setGlyphIndexes(idx);
-      glyphs.setPositions(adv);
-      glyphs.setRawFont(rfont);
+      QVector<quint32> indexes(n);
+      QVector<QPointF> positions(n);
+      for (int k = 0; k < n; ++k) {
+            indexes[k]   = idx.isEmpty() ? 0 : idx[0];
+            positions[k] = QPointF(w * k, 0.0);
+            }
+      QGlyphRun run;
+      run.setRawFont(rfont);
+      run.setGlyphIndexes(indexes);
+      run.setPositions(positions);
+      return cache->runs.insert(key, run).value();
       }
 #endif
 
@@ -385,9 +439,6 @@ Sym::Sym(int c, int fid, qreal ax, qreal ay)
             }
       w     = fm.width(_code);
       _bbox = fm.boundingRect(_code);
-#ifdef USE_GLYPHS
-      genGlyphs(fontId2font(fontId));
-#endif
       }
 
 Sym::Sym(int c, int fid, const QPointF& a, const QRectF& b)
@@ -397,9 +448,6 @@ Sym::Sym(int c, int fid, const QPointF& a, const QRectF& b)
       _bbox.setRect(b.x() * ds, b.y() * ds, b.width() * ds, b.height() * ds);
       _attach = a * ds;
       w = _bbox.width();
-#ifdef USE_GLYPHS
-      genGlyphs(fontId2font(fontId));
-#endif
       }
 
 //---------------------------------------------------------
@@ -420,10 +468,7 @@ void Sym::draw(QPainter* painter, qreal mag, const QPointF& pos) const
       qreal imag = 1.0 / mag;
       painter->scale(mag, mag);
 #ifdef USE_GLYPHS
-      {
-      QWriteLocker locker(&gLock);
-      painter->drawGlyphRun(pos * imag, glyphs);
-      }
+      painter->drawGlyphRun(pos * imag, glyphRun(1));
 #else
       painter->setFont(font());
       painter->drawText(pos * imag, toString());
@@ -453,25 +498,12 @@ QString Sym::toString() const
 
 void Sym::draw(QPainter* painter, qreal mag, const QPointF& pos, int n) const
       {
-#ifdef USE_GLYPHS
-      QVector<quint32> indexes(n);
-      QVector<QPointF> positions(n);
-      QGlyphRun nglyphs;
-      nglyphs.setRawFont(glyphs.rawFont());
-
-      positions[0] = QPointF();
-      for (int i = 0; i < n; ++i) {
-            indexes[i] = glyphs.glyphIndexes()[0];
-            if (i)
-                  positions[i] = QPointF(w * i, 0.0);
-            }
-      nglyphs.setGlyphIndexes(indexes);
-      nglyphs.setPositions(positions);
-#endif
+      if (n <= 0)
+            return;
       painter->scale(mag, mag);
       qreal imag = 1.0 / mag;
 #ifdef USE_GLYPHS
-      painter->drawGlyphRun(pos * imag, nglyphs);
+      painter->drawGlyphRun(pos * imag, glyphRun(n));
 #else
       painter->setFont(font());
       painter->drawText(pos * imag, QString(n, _code));
@@ -589,11 +621,19 @@ void Sym::init()
 
 void initSymbols(int idx)
       {
+      // called from every layout; part scores are laid out concurrently
+      static QMutex mutex;
+      QMutexLocker locker(&mutex);
       if (symbolsInitialized[idx])
             return;
       symbolsInitialized[idx] = true;
       symbols[idx] = QVector<Sym>(lastSym);
 
+      // create the cached fonts now; later lookups from
+      // painting threads are read only
+      for (int i = 0; i < 4; ++i)
+            fontId2font(i);
+
       symbols[idx][clefEightSym] = Sym(0x38, 2);
       symbols[idx][clefOneSym]   = Sym(0x31, 2);
       symbols[idx][clefFiveSym]  = Sym(0x35, 2);
@@ -332,8 +332,7 @@ class Sym {
       QPointF _attach;
 
 #ifdef USE_GLYPHS
-      QGlyphRun glyphs;       // cached values
-      void genGlyphs(const QFont& font);
+      const QGlyphRun& glyphRun(int n) const;
 #endif
 
       static QVector<const char*> symNames;
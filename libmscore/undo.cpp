@@ -211,12 +211,67 @@ void UndoStack::endMacro(bool rollback)
       curCmd = 0;
       }
 
+//---------------------------------------------------------
+//   deferredCommands
+//    commands pushed by a thread between beginDeferred()
+//    and takeDeferred()
+//---------------------------------------------------------
+
+static QThreadStorage<QList<UndoCommand*>*> deferredCommands;
+
+//---------------------------------------------------------
+//   beginDeferred
+//    Collect the commands pushed by this thread instead of
+//    appending them to the current macro. Part scores laid
+//    out concurrently use this to keep their commands in
+//    a fixed order.
+//---------------------------------------------------------
+
+void UndoStack::beginDeferred()
+      {
+      deferredCommands.setLocalData(new QList<UndoCommand*>);
+      }
+
+//---------------------------------------------------------
+//   takeDeferred
+//---------------------------------------------------------
+
+QList<UndoCommand*> UndoStack::takeDeferred()
+      {
+      QList<UndoCommand*> cl;
+      if (deferredCommands.hasLocalData() && deferredCommands.localData()) {
+            cl = *deferredCommands.localData();
+            deferredCommands.setLocalData(0);
+            }
+      return cl;
+      }
+
+//---------------------------------------------------------
+//   appendDeferred
+//    append collected commands, they are already done
+//---------------------------------------------------------
+
+void UndoStack::appendDeferred(const QList<UndoCommand*>& cl)
+      {
+      foreach(UndoCommand* cmd, cl) {
+            if (curCmd)
+                  curCmd->appendChild(cmd);
+            else
+                  delete cmd;
+            }
+      }
+
 //---------------------------------------------------------
 //   push
 //---------------------------------------------------------
 
 void UndoStack::push(UndoCommand* cmd)
       {
+      if (curCmd && deferredCommands.hasLocalData() && deferredCommands.localData()) {
+            deferredCommands.localData()->append(cmd);
+            cmd->redo();
+            return;
+            }
       if (!curCmd) {
             // this can happen for layout() outside of a command (load)
             // qDebug("UndoStack:push(): no active command, UndoStack %p", this);
@@ -234,7 +289,10 @@ void UndoStack::push(UndoCommand* cmd)
             qDebug("UndoStack::push <%s> %p", cmd->name(), cmd);
             }
 #endif
+      {
+      QMutexLocker locker(&mutex);
       curCmd->appendChild(cmd);
+      }
       cmd->redo();
       }
 
@@ -1559,8 +1617,7 @@ void ChangePitch::flip()
             Measure* measure = chord->segment()->measure();
             score->updateAccidentals(measure, chord->staffIdx());
             }
-      // score->setLayout(measure);
-      score->setLayoutAll(true);
+      score->setLayout(note->chord()->measure());
       }
 
 //---------------------------------------------------------
@@ -2336,7 +2393,7 @@ void ChangeStretch::flip()
       {
       qreal oStretch = measure->userStretch();
       measure->setUserStretch(stretch);
-      measure->score()->setLayoutAll(true);
+      measure->score()->setLayout(measure);
       stretch = oStretch;
       }
 
@@ -2409,7 +2466,7 @@ void ChangeChordStaffMove::flip()
       int v = chord->staffMove();
       chord->setStaffMove(staffMove);
       chord->score()->updateAccidentals(chord->measure(), chord->staffIdx());
-      chord->score()->setLayoutAll(true);
+      chord->score()->setLayout(chord->measure());
       staffMove = v;
       }
 
@@ -2866,7 +2923,8 @@ void SwapCR::flip()
       Element* cr = s1->element(track);
       s1->setElement(track, s2->element(track));
       s2->setElement(track, cr);
-      cr1->score()->setLayoutAll(true);
+      cr1->score()->setLayout(s1->measure());
+      cr1->score()->setLayout(s2->measure());
       }
 
 //---------------------------------------------------------
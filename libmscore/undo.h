@@ -110,6 +110,7 @@ class UndoCommand {
 
 class UndoStack {
       UndoCommand* curCmd;
+      QMutex mutex;                 ///< part scores push concurrently during layout
       QList<UndoCommand*> list;
       int curIdx;
       int cleanIdx;
@@ -122,6 +123,9 @@ class UndoStack {
       void beginMacro();
       void endMacro(bool rollback);
       void push(UndoCommand*);
+      void beginDeferred();
+      QList<UndoCommand*> takeDeferred();
+      void appendDeferred(const QList<UndoCommand*>&);
       void pop();
       void setClean();
       bool canUndo() const          { return curIdx > 0;           }
@@ -35,20 +35,65 @@ QRectF handleRect(const QPointF& pos)
       return QRectF(pos.x()-4, pos.y()-4, 8, 8);
       }
 
+//---------------------------------------------------------
+//   tickIndex
+//    return list of all measures in score order; the
+//    list is rebuild if the measure list has changed
+//---------------------------------------------------------
+
+const QVector<Measure*>& Score::tickIndex() const
+      {
+      if (_tickIndexSerial != _measures.serial()) {
+            _tickIndex.clear();
+            _tickIndex.reserve(_measures.size());
+            for (Measure* m = firstMeasure(); m; m = m->nextMeasure())
+                  _tickIndex.append(m);
+            _tickIndexSerial = _measures.serial();
+            }
+      return _tickIndex;
+      }
+
 //---------------------------------------------------------
 //   tick2measure
 //---------------------------------------------------------
 
 Measure* Score::tick2measure(int tick) const
       {
+      const QVector<Measure*>& ml = tickIndex();
+      if (ml.isEmpty()) {
+            qDebug("-tick2measure %d not found", tick);
+            return 0;
+            }
+      //
+      // binary search for the last measure starting at or
+      // before tick
+      //
+      int lo = 0;
+      int hi = ml.size();
+      while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (ml[mid]->tick() <= tick)
+                  lo = mid + 1;
+            else
+                  hi = mid;
+            }
+      if (lo > 0) {
+            Measure* m = ml[lo - 1];
+            int st = m->tick();
+            if (tick < st + m->ticks())
+                  return m;
+            }
+      Measure* lm = ml.last();
+      if (tick == lm->tick() + lm->ticks())
+            return lm;
+
+      // measure ticks are not in order (fixTicks() not yet called)
       for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
             int st = m->tick();
             int l  = m->ticks();
             if (tick >= st && tick < (st+l))
                   return m;
             }
-      if(tick == lastMeasure()->tick() + lastMeasure()->ticks())
-            return lastMeasure();
       qDebug("-tick2measure %d not found", tick);
       return 0;
       }
@@ -80,8 +125,13 @@ Segment* Score::tick2segment(int tick, bool first, Segment::SegmentTypes st) con
             qDebug("   no segment for tick %d\n", tick);
             return 0;
             }
-      for (Segment* segment = m->first(st); segment;) {
+      Segment* segment = m->firstSegmentAt(tick);
+      if (segment && !(segment->subtype() & st))
+            segment = segment->next(st);
+      for (; segment;) {
             int t1 = segment->tick();
+            if (t1 > tick)
+                  break;
             Segment* nsegment = segment->next(st);
             int t2 = nsegment ? nsegment->tick() : INT_MAX;
             if (((tick == t1) && first) || ((tick == t1) && (tick < t2)))
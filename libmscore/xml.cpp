@@ -27,29 +27,133 @@ XmlReader::XmlReader(QFile* d)
    : QXmlStreamReader(d)
       {
       docName = d->fileName();
-      _tick  = 0;
-      _track = 0;
+      init();
       }
 
 XmlReader::XmlReader(const QByteArray& d)
    : QXmlStreamReader(d)
       {
-      _tick  = 0;
-      _track = 0;
+      init();
       }
 
 XmlReader::XmlReader(QIODevice* d)
    : QXmlStreamReader(d)
       {
-      _tick  = 0;
-      _track = 0;
+      init();
       }
 
 XmlReader::XmlReader(const QString& d)
    : QXmlStreamReader(d)
       {
-      _tick  = 0;
-      _track = 0;
+      init();
+      }
+
+//---------------------------------------------------------
+//   init
+//---------------------------------------------------------
+
+void XmlReader::init()
+      {
+      _tick      = 0;
+      _track     = 0;
+      _tagOffset = -1;
+      _tag       = TAG_UNKNOWN;
+      }
+
+//---------------------------------------------------------
+//   tag
+//    interned name of the current start element; the
+//    lookup is done once per element even if several
+//    readProperties() levels ask for it
+//---------------------------------------------------------
+
+XmlTag XmlReader::tag() const
+      {
+      qint64 offset = characterOffset();
+      if (offset != _tagOffset) {
+            _tagOffset = offset;
+            _tag       = xmlTag(name());
+            }
+      return _tag;
+      }
+
+//---------------------------------------------------------
+//   parseInt
+//    parse the common forms of a decimal integer without
+//    creating a QString; return false for anything
+//    QString::toInt() has to handle
+//---------------------------------------------------------
+
+static bool parseInt(const QStringRef& ref, int* val)
+      {
+      const QChar* s = ref.unicode();
+      int n = ref.size();
+      if (n > 32)
+            return false;
+      int i = 0;
+      while (i < n && (s[i] == ' ' || s[i] == '\n' || s[i] == '\r' || s[i] == '\t'))
+            ++i;
+      bool neg = false;
+      if (i < n && (s[i] == '-' || s[i] == '+'))
+            neg = s[i++] == '-';
+      int digits = 0;
+      int v = 0;
+      for (; i < n; ++i, ++digits) {
+            ushort c = s[i].unicode();
+            if (c < '0' || c > '9')
+                  break;
+            v = v * 10 + (c - '0');
+            }
+      if (digits == 0 || digits > 9)
+            return false;
+      while (i < n && (s[i] == ' ' || s[i] == '\n' || s[i] == '\r' || s[i] == '\t'))
+            ++i;
+      if (i != n)
+            return false;
+      *val = neg ? -v : v;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   readInt
+//    same as readElementText().toInt() but the usual
+//    <tag>number</tag> is parsed from the token
+//---------------------------------------------------------
+
+int XmlReader::readInt(bool* ok)
+      {
+      QString s;
+      int val;
+      if (readNext() == Characters && parseInt(text(), &val)) {
+            QChar buf[32];
+            int n = text().size();
+            memcpy(buf, text().unicode(), n * sizeof(QChar));
+            if (readNext() == EndElement) {
+                  if (ok)
+                        *ok = true;
+                  return val;
+                  }
+            s = QString(buf, n);
+            }
+      // general case, see QXmlStreamReader::readElementText()
+      for (;;) {
+            switch (tokenType()) {
+                  case Characters:
+                  case EntityReference:
+                        s += text();
+                        break;
+                  case ProcessingInstruction:
+                  case Comment:
+                        break;
+                  case StartElement:
+                        raiseError(QObject::tr("Expected character data."));
+                        return s.toInt(ok);
+                  case EndElement:
+                  default:
+                        return s.toInt(ok);
+                  }
+            readNext();
+            }
       }
 
 //---------------------------------------------------------
@@ -336,7 +440,8 @@ PlaceText readPlacement(XmlReader& e)
 
 void Xml::fTag(const char* name, const Fraction& f)
       {
-      tagE(QString("%1 z=\"%2\" n=\"%3\"").arg(name).arg(f.numerator()).arg(f.denominator()));
+      putLevel();
+      *this << '<' << name << " z=\"" << f.numerator() << "\" n=\"" << f.denominator() << "\"/>\n";
       }
 
 //---------------------------------------------------------
@@ -345,9 +450,28 @@ void Xml::fTag(const char* name, const Fraction& f)
 
 void Xml::putLevel()
       {
-      int level = stack.size();
-      for (int i = 0; i < level * 2; ++i)
-            *this << ' ';
+      static const int MAX_INDENT = 128;
+      static const char spaces[MAX_INDENT + 1] =
+         "                                                                "
+         "                                                                ";
+      int n = stack.size() * 2;
+      for (; n > MAX_INDENT; n -= MAX_INDENT)
+            *this << spaces;
+      *this << (spaces + MAX_INDENT - n);
+      }
+
+//---------------------------------------------------------
+//   putEndName
+//    write the tag name without attributes
+//---------------------------------------------------------
+
+void Xml::putEndName(const char* name)
+      {
+      const char* p = strchr(name, ' ');
+      if (p)
+            *this << QString::fromAscii(name, p - name);
+      else
+            *this << name;
       }
 
 //---------------------------------------------------------
@@ -368,7 +492,7 @@ void Xml::stag(const QString& s)
       {
       putLevel();
       *this << '<' << s << '>' << endl;
-      stack.append(s.split(' ')[0]);
+      stack.append(s.left(s.indexOf(' ')));
       }
 
 //---------------------------------------------------------
@@ -525,13 +649,73 @@ void Xml::tag(P_ID id, QVariant data, QVariant defaultData)
 
 void Xml::tag(const char* name, QVariant data, QVariant defaultData)
       {
-      if (data != defaultData)
-            tag(QString(name), data);
+      if (data == defaultData)
+            return;
+      switch(data.type()) {
+            case QVariant::Bool:
+            case QVariant::Char:
+            case QVariant::Int:
+            case QVariant::UInt:
+                  tag(name, data.toInt());
+                  break;
+            case QVariant::Double:
+                  tag(name, data.value<double>());
+                  break;
+            case QVariant::PointF:
+                  tag(name, data.value<QPointF>());
+                  break;
+            case QVariant::Color:
+                  tag(name, data.value<QColor>());
+                  break;
+            default:
+                  tag(QString(name), data);
+                  break;
+            }
+      }
+
+//---------------------------------------------------------
+//   tag
+//    typed versions of tag(), they avoid the QVariant
+//    and QString temporaries
+//---------------------------------------------------------
+
+void Xml::tag(const char* name, int val)
+      {
+      putLevel();
+      *this << '<' << name << '>' << val << "</";
+      putEndName(name);
+      *this << ">\n";
+      }
+
+void Xml::tag(const char* name, unsigned val)
+      {
+      tag(name, int(val));
+      }
+
+void Xml::tag(const char* name, double val)
+      {
+      putLevel();
+      *this << '<' << name << '>' << val << "</";
+      putEndName(name);
+      *this << ">\n";
+      }
+
+void Xml::tag(const char* name, const QPointF& p)
+      {
+      putLevel();
+      *this << '<' << name << " x=\"" << p.x() << "\" y=\"" << p.y() << "\"/>\n";
+      }
+
+void Xml::tag(const char* name, const QColor& color)
+      {
+      putLevel();
+      *this << '<' << name << " r=\"" << color.red() << "\" g=\"" << color.green()
+         << "\" b=\"" << color.blue() << "\" a=\"" << color.alpha() << "\"/>\n";
       }
 
 void Xml::tag(const QString& name, QVariant data)
       {
-      QString ename(name.split(' ')[0]);
+      QString ename(name.left(name.indexOf(' ')));
 
       putLevel();
       switch(data.type()) {
@@ -18,6 +18,7 @@
 #include "spatium.h"
 #include "fraction.h"
 #include "property.h"
+#include "xmltags.h"
 
 class Spanner;
 class Beam;
@@ -37,6 +38,11 @@ class XmlReader : public QXmlStreamReader {
       QList<Beam*>    _beams;
       QList<Tuplet*>  _tuplets;
 
+      mutable qint64 _tagOffset;    // token of the cached _tag
+      mutable XmlTag _tag;
+
+      void init();
+
    public:
       XmlReader(QFile*);
       XmlReader(const QByteArray& d);
@@ -56,9 +62,11 @@ class XmlReader : public QXmlStreamReader {
       double doubleAttribute(const char* s, double _default) const;
       bool hasAttribute(const char* s) const;
 
+      XmlTag tag() const;
+
       // helper routines based on readElementText():
-      int readInt()         { return readElementText().toInt();    }
-      int readInt(bool* ok) { return readElementText().toInt(ok);  }
+      int readInt()         { return readInt(0);  }
+      int readInt(bool* ok);
       double readDouble()   { return readElementText().toDouble(); }
       QPointF readPoint();
       QSizeF readSize();
@@ -94,6 +102,7 @@ class Xml : public QTextStream {
 
       QList<QString> stack;
       void putLevel();
+      void putEndName(const char* name);
       QList<Spanner*> _spanner;
 
    public:
@@ -115,7 +124,7 @@ class Xml : public QTextStream {
       Xml(QIODevice* dev);
       Xml();
 
-      void sTag(const char* name, Spatium sp) { Xml::tag(name, QVariant(sp.val())); }
+      void sTag(const char* name, Spatium sp) { tag(name, sp); }
       void pTag(const char* name, PlaceText);
       void fTag(const char* name, const Fraction&);
 
@@ -137,6 +146,14 @@ class Xml : public QTextStream {
       void tag(const char* name, const QString& s) { tag(name, QVariant(s)); }
       void tag(const char* name, const QWidget*);
 
+      void tag(const char* name, int);
+      void tag(const char* name, unsigned);
+      void tag(const char* name, double);
+      void tag(const char* name, Spatium sp)       { tag(name, sp.val()); }
+      void tag(const char* name, const QPointF&);
+      void tag(const char* name, const Fraction& f) { fTag(name, f); }
+      void tag(const char* name, const QColor&);
+
       void writeHtml(const QString& s);
       void dump(int len, const unsigned char* p);
 
@@ -0,0 +1,311 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2013 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "xmltags.h"
+
+//---------------------------------------------------------
+//   tagNames
+//    indexed by XmlTag
+//---------------------------------------------------------
+
+static const char* const tagNames[] = {
+      "",
+      "Accidental",
+      "Arpeggio",
+      "Articulation",
+      "Attribute",
+      "Audio",
+      "BarLine",
+      "Beam",
+      "BeamMode",
+      "Bend",
+      "Breath",
+      "Chord",
+      "ChordLine",
+      "Clef",
+      "Division",
+      "Dynamic",
+      "Event",
+      "Events",
+      "Excerpt",
+      "FiguredBass",
+      "Fingering",
+      "FretDiagram",
+      "Glissando",
+      "HairPin",
+      "Harmony",
+      "Hook",
+      "Image",
+      "InstrumentChange",
+      "Jump",
+      "KeySig",
+      "Layer",
+      "LayerTag",
+      "LayoutBreak",
+      "Lyrics",
+      "Mag",
+      "MagIdx",
+      "Marker",
+      "MeasureNumber",
+      "Note",
+      "NoteDot",
+      "Omr",
+      "Ottava",
+      "PageList",
+      "Part",
+      "Pedal",
+      "RehearsalMark",
+      "RepeatMeasure",
+      "Rest",
+      "Score",
+      "Segment",
+      "Slur",
+      "Spatium",
+      "Staff",
+      "StaffState",
+      "StaffText",
+      "StaffType",
+      "Stem",
+      "StemDirection",
+      "Style",
+      "Symbol",
+      "Symbols",
+      "SyntiSettings",
+      "Tempo",
+      "Text",
+      "TextLine",
+      "TextStyle",
+      "Tie",
+      "TimeSig",
+      "Tremolo",
+      "Trill",
+      "Tuplet",
+      "Volta",
+      "acciaccatura",
+      "appoggiatura",
+      "breakMultiMeasureRest",
+      "color",
+      "copyright",
+      "currentLayer",
+      "cursorTrack",
+      "dotPosition",
+      "dots",
+      "duration",
+      "durationType",
+      "endRepeat",
+      "endSpanner",
+      "fret",
+      "ghost",
+      "grace16",
+      "grace32",
+      "grace4",
+      "head",
+      "headType",
+      "irregular",
+      "leadingSpace",
+      "lid",
+      "line",
+      "metaTag",
+      "mirror",
+      "move",
+      "movement-number",
+      "movement-title",
+      "name",
+      "noOffset",
+      "noStem",
+      "offTimeOffset",
+      "offTimeType",
+      "offset",
+      "onTimeOffset",
+      "onTimeType",
+      "page-layout",
+      "page-offset",
+      "pitch",
+      "placement",
+      "playMode",
+      "pos",
+      "programRevision",
+      "programVersion",
+      "rights",
+      "selected",
+      "showFrames",
+      "showInvisible",
+      "showMargins",
+      "showOmr",
+      "showUnprintable",
+      "siglist",
+      "slashStyle",
+      "small",
+      "source",
+      "startRepeat",
+      "stretch",
+      "string",
+      "subtype",
+      "tag",
+      "tempolist",
+      "tick",
+      "tickOffset",
+      "ticklen",
+      "tpc",
+      "track",
+      "trailingSpace",
+      "tuning",
+      "userAccidental",
+      "userOff",
+      "veloType",
+      "velocity",
+      "visible",
+      "voice",
+      "vspacer",
+      "vspacerDown",
+      "vspacerUp",
+      "work-number",
+      "work-title",
+      "xoff",
+      "yoff",
+      };
+
+//---------------------------------------------------------
+//   tagSlot
+//    perfect hash table: maps tagHash() of a name in
+//    tagNames to its XmlTag.
+//    TAG_SEED is chosen so that no two names share a slot;
+//    a new tag name requires a new search for a seed.
+//---------------------------------------------------------
+
+static const unsigned TAG_SEED  = 2744;
+static const int TAG_SLOTS      = 1024;
+
+static const unsigned char tagSlot[TAG_SLOTS] = {
+        0,   0,   0,   0,   0,   0,  28,   0,   0,   0, 112,   0,   0,   0,   0,   0,
+        0,   0,   0,   0, 137,   0,   0,   0,   0,  53,   0,   0,   0,   0, 130,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 116,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,  92, 132,   0,   0,   0,  54,   9,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 123,   0,   0,   0,   0,   0,
+       93,   0,   0,   0,   0,   0,   0,   0,   0, 121, 109,   0,   0,   0,   0,   0,
+        0,   0,   0,   0, 113,   0,   0,   0,   0,   0,   0,   0,   0,   0,  72,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   5,  47,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 148,  35,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,  95,   0,   0,  18,   0,   0,   0,   0,   0,   0,   0,  52,
+       56,   0,   0,   0,   0,   0,  83,   0,   0,   0,   0,  36,   0,   0, 144,   0,
+        0,   0,   0,   0,   0,   0,   0,  65,   0,   0, 110,   0,   0,   0,   0,   0,
+        0,   0,  39,   0,   0,   0,  80,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0, 117,   0,   0,   0,   0,   0, 128,   0,  62,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  44,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  38,   0,   0,
+        0,   0,   0,   0,   0,   0,   0, 111,   0,   0,   0,   0,   0,   0,   0,   3,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 134,   0,  31,   0,   0,   0,
+        0,  51,   0,   0,   0,  63,   0,  17,  59,   0,   0,   0,   6,   0, 103,   0,
+        0,   0, 153,   0,   0,  98,   0, 129,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0, 118,   0,   0,   0,   0,   0,  86,   0,   0,   0,   0,   0,   0,  20,
+        0,   0,   0,   0,   0,   0,   0, 143,   0,   0,   0,   0,   0,  42,   0,   0,
+      106,   0,   0,   0,   0,   0,  21,  74,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  84,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   8,   0,   0,   0,  79,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0, 150,   0,   0,   0,   0,   0, 124,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  91,   0,   0,   0,
+        0,   0,   0,  30,   0,   0,   0,   0,   0,   0, 147,   0,   0,   0,   0,   0,
+        0,   0, 140,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,  70,   0, 122,   0, 100,   0,   0,   0, 135,   0,   0,   0,   0, 114,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,  57,   0,   0,   0,   0,   0,   0,
+        0,   0,   0, 108,   0,   0,   0,   0,   0,   0,  81,  32,   0,   0,   0,  77,
+        0, 127,   0,  19,   0,   0,   0,   0,  11,  90,  13,   0,   0,   0,   0,   0,
+       29,   0,   0,   0,   0,  60,   0,   0,   0,   0,   0,   0,   0,  16,   0,   0,
+        0,   0,  45,   0,   0,   0,   0,   0,   0,   0, 133,   0,   0,   0,   0, 120,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,  41,   0,   0,  61,   0,   0,   0, 136,   0,   0, 145,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,  78,   0,   0,   0,   0, 152,   0,   0,
+        0,  46,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,  82,  96,   0,   0,   0,   0,  12,   0,   0,   0,   0,  97,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   2,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0, 125,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,  26,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  27,   0,   0,
+        0,   4,   0,   0, 101,   0,   0,   0,  50, 138,   0,   0,   0,   0,   0,   0,
+       25,   0,   0,   0,   0, 104,   0,   0,   0,   0,  68,   0,   0,   0,  49,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 139,
+        0,   0,   0,  89,   0,   0,   0,   0,   0,   0,  23,  73,   0,   0,   0,   0,
+        0,   0,   0,  37,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0, 141,   0,   0,  99,   0,   0,   0,   0, 102,   0,   0,   0,   0,   0,   0,
+        0, 115,  85,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,  24,   0,   0,   0,   7,  58,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+       55,   0,   0,   0,   0,  34,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0, 131,   0,   0,   0,   0,   0,  87,   0,   0,   0,   0,  88,   0,
+        0,   0,   0,  71,   0, 126,  64,   0,   0,   0,   0,   0,   0,   0,   0,  43,
+        0,   0,   0,   0, 149,   0,   0,   1,   0,   0,   0,  66,   0,   0,   0,   0,
+        0,   0,   0,  69,   0, 105,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,  40,  14, 142,  22,  48,   0,   0, 107,   0,   0,   0,
+        0,  76,   0,   0,   0,  75,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0, 151,   0,   0,   0,   0,   0, 146,  67,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,  33,  94,   0,   0,   0,   0, 119,   0,   0,   0,   0,  10,
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  15,   0,
+      };
+
+//---------------------------------------------------------
+//   tagHash
+//    FNV-1a over the utf16 characters
+//---------------------------------------------------------
+
+static inline int tagHash(const QChar* s, int n)
+      {
+      unsigned h = TAG_SEED ^ unsigned(n);
+      for (int i = 0; i < n; ++i)
+            h = (h ^ s[i].unicode()) * 16777619u;
+      return (h >> 16) & (TAG_SLOTS - 1);
+      }
+
+#ifndef NDEBUG
+//---------------------------------------------------------
+//   checkTags
+//    verify that the table matches tagNames
+//---------------------------------------------------------
+
+static bool checkTags()
+      {
+      for (int i = 1; i < TAG_END; ++i) {
+            QString s(tagNames[i]);
+            if (tagSlot[tagHash(s.unicode(), s.size())] != i)
+                  qFatal("xmlTag: bad hash table for <%s>", tagNames[i]);
+            }
+      return true;
+      }
+#endif
+
+//---------------------------------------------------------
+//   xmlTag
+//    return TAG_UNKNOWN for names not in tagNames
+//---------------------------------------------------------
+
+XmlTag xmlTag(const QStringRef& name)
+      {
+#ifndef NDEBUG
+      static bool checked = checkTags();
+      Q_UNUSED(checked);
+#endif
+      int idx = tagSlot[tagHash(name.unicode(), name.size())];
+      if (idx && name == QLatin1String(tagNames[idx]))
+            return XmlTag(idx);
+      return TAG_UNKNOWN;
+      }
+
+//---------------------------------------------------------
+//   xmlTagName
+//---------------------------------------------------------
+
+const char* xmlTagName(XmlTag tag)
+      {
+      return tagNames[tag];
+      }
+
@@ -0,0 +1,186 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2013 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __XMLTAGS_H__
+#define __XMLTAGS_H__
+
+//---------------------------------------------------------
+//   XmlTag
+//    interned names of the tags read by Score::read(),
+//    Score::read114() and the inner loops of the score
+//    reader (see XmlReader::tag())
+//---------------------------------------------------------
+
+enum XmlTag {
+      TAG_UNKNOWN,
+      TAG_Accidental,
+      TAG_Arpeggio,
+      TAG_Articulation,
+      TAG_Attribute,
+      TAG_Audio,
+      TAG_BarLine,
+      TAG_Beam,
+      TAG_BeamMode,
+      TAG_Bend,
+      TAG_Breath,
+      TAG_Chord,
+      TAG_ChordLine,
+      TAG_Clef,
+      TAG_Division,
+      TAG_Dynamic,
+      TAG_Event,
+      TAG_Events,
+      TAG_Excerpt,
+      TAG_FiguredBass,
+      TAG_Fingering,
+      TAG_FretDiagram,
+      TAG_Glissando,
+      TAG_HairPin,
+      TAG_Harmony,
+      TAG_Hook,
+      TAG_Image,
+      TAG_InstrumentChange,
+      TAG_Jump,
+      TAG_KeySig,
+      TAG_Layer,
+      TAG_LayerTag,
+      TAG_LayoutBreak,
+      TAG_Lyrics,
+      TAG_Mag,
+      TAG_MagIdx,
+      TAG_Marker,
+      TAG_MeasureNumber,
+      TAG_Note,
+      TAG_NoteDot,
+      TAG_Omr,
+      TAG_Ottava,
+      TAG_PageList,
+      TAG_Part,
+      TAG_Pedal,
+      TAG_RehearsalMark,
+      TAG_RepeatMeasure,
+      TAG_Rest,
+      TAG_Score,
+      TAG_Segment,
+      TAG_Slur,
+      TAG_Spatium,
+      TAG_Staff,
+      TAG_StaffState,
+      TAG_StaffText,
+      TAG_StaffType,
+      TAG_Stem,
+      TAG_StemDirection,
+      TAG_Style,
+      TAG_Symbol,
+      TAG_Symbols,
+      TAG_SyntiSettings,
+      TAG_Tempo,
+      TAG_Text,
+      TAG_TextLine,
+      TAG_TextStyle,
+      TAG_Tie,
+      TAG_TimeSig,
+      TAG_Tremolo,
+      TAG_Trill,
+      TAG_Tuplet,
+      TAG_Volta,
+      TAG_acciaccatura,
+      TAG_appoggiatura,
+      TAG_breakMultiMeasureRest,
+      TAG_color,
+      TAG_copyright,
+      TAG_currentLayer,
+      TAG_cursorTrack,
+      TAG_dotPosition,
+      TAG_dots,
+      TAG_duration,
+      TAG_durationType,
+      TAG_endRepeat,
+      TAG_endSpanner,
+      TAG_fret,
+      TAG_ghost,
+      TAG_grace16,
+      TAG_grace32,
+      TAG_grace4,
+      TAG_head,
+      TAG_headType,
+      TAG_irregular,
+      TAG_leadingSpace,
+      TAG_lid,
+      TAG_line,
+      TAG_metaTag,
+      TAG_mirror,
+      TAG_move,
+      TAG_movement_number,
+      TAG_movement_title,
+      TAG_name,
+      TAG_noOffset,
+      TAG_noStem,
+      TAG_offTimeOffset,
+      TAG_offTimeType,
+      TAG_offset,
+      TAG_onTimeOffset,
+      TAG_onTimeType,
+      TAG_page_layout,
+      TAG_page_offset,
+      TAG_pitch,
+      TAG_placement,
+      TAG_playMode,
+      TAG_pos,
+      TAG_programRevision,
+      TAG_programVersion,
+      TAG_rights,
+      TAG_selected,
+      TAG_showFrames,
+      TAG_showInvisible,
+      TAG_showMargins,
+      TAG_showOmr,
+      TAG_showUnprintable,
+      TAG_siglist,
+      TAG_slashStyle,
+      TAG_small,
+      TAG_source,
+      TAG_startRepeat,
+      TAG_stretch,
+      TAG_string,
+      TAG_subtype,
+      TAG_tag,
+      TAG_tempolist,
+      TAG_tick,
+      TAG_tickOffset,
+      TAG_ticklen,
+      TAG_tpc,
+      TAG_track,
+      TAG_trailingSpace,
+      TAG_tuning,
+      TAG_userAccidental,
+      TAG_userOff,
+      TAG_veloType,
+      TAG_velocity,
+      TAG_visible,
+      TAG_voice,
+      TAG_vspacer,
+      TAG_vspacerDown,
+      TAG_vspacerUp,
+      TAG_work_number,
+      TAG_work_title,
+      TAG_xoff,
+      TAG_yoff,
+      TAG_END
+      };
+
+extern XmlTag xmlTag(const QStringRef&);
+extern const char* xmlTagName(XmlTag);
+
+#endif
+
@@ -285,14 +285,35 @@ qDebug("  already there %d %d\n", i, n);
 
 void ExcerptsDialog::createAllExcerptsClicked()
       {
+      QList<Excerpt*> excerpts;
       int n = excerptList->count();
       for (int i = 0; i < n; ++i) {
-            excerptList->setCurrentRow(i);
-            QListWidgetItem* cur = excerptList->currentItem();
-            if (cur == 0)
+            Excerpt* e = static_cast<ExcerptItem*>(excerptList->item(i))->excerpt();
+            if (e->score() == 0)
+                  excerpts.append(e);
+            }
+      if (excerpts.isEmpty())
+            return;
+      ::createExcerpts(excerpts);         // clone and layout on the thread pool
+
+      score->startCmd();
+      foreach(Excerpt* e, excerpts) {
+            Score* nscore = e->score();
+            if (nscore == 0)
                   continue;
-            createExcerptClicked(cur);
+            nscore->setParentScore(score);
+            nscore->addLayoutFlags(LAYOUT_FIX_PITCH_VELO);
+            nscore->setLayoutAll(true);
+            score->undo(new AddExcerpt(nscore));
             }
+      score->endCmd();
+      foreach(Excerpt* e, excerpts) {
+            if (e->score())
+                  e->score()->style()->set(ST_createMultiMeasureRests, true);
+            }
+      excerptList->setCurrentRow(n - 1);
+      partList->setEnabled(false);
+      title->setEnabled(false);
       }
 
 //---------------------------------------------------------
@@ -78,80 +78,113 @@ bool MuseScore::saveAudio(Score* score, const QString& name, const QString& ext)
       QProgressBar* pBar = showProgressBar();
       pBar->reset();
 
+      //
+      // render once at unity gain into a float spill file;
+      // the peak is known after rendering and the data is
+      // normalized while it is encoded
+      //
+      QTemporaryFile spill;
+      if (!spill.open()) {
+            qDebug("cannot create audio spill file\n");
+            sf_close(sf);
+            hideProgressBar();
+            delete synti;
+            MScore::sampleRate = oldSampleRate;
+            return false;
+            }
+
       float peak = 0.0;
-      double gain = 1.0;
       EventMap::const_iterator endPos = events.constEnd();
       --endPos;
-      const int et = (score->utick2utime(endPos.key()) + 1) * MScore::sampleRate;
-      for (int pass = 0; pass < 2; ++pass) {
-            EventMap::const_iterator playPos;
-            playPos = events.constBegin();
-            pBar->setRange(0, et);
+      const int et = (score->utick2utime(endPos->tick()) + 1) * MScore::sampleRate;
+      EventMap::const_iterator playPos = events.constBegin();
+      pBar->setRange(0, et);
+
+      //
+      // init instruments
+      //
+      foreach(const Part* part, score->parts()) {
+            foreach(const Channel& a, part->instr()->channel()) {
+                  a.updateInitList();
+                  foreach(Event e, a.init) {
+                        if (e.type() == ME_INVALID)
+                              continue;
+                        e.setChannel(a.channel);
+                        int syntiIdx= score->midiMapping(a.channel)->articulation->synti;
+                        synti->prepare(e, syntiIdx);
+                        synti->play(e, syntiIdx);
+                        }
+                  }
+            }
+
+      static const unsigned FRAMES = 512;
+      float buffer[FRAMES * 2];
+      int playTime = 0;
+      synti->setGain(1.0);
 
+      bool ok = true;
+      for (;;) {
+            unsigned frames = FRAMES;
             //
-            // init instruments
+            // collect events for one segment
             //
-            foreach(const Part* part, score->parts()) {
-                  foreach(const Channel& a, part->instr()->channel()) {
-                        a.updateInitList();
-                        foreach(Event e, a.init) {
-                              if (e.type() == ME_INVALID)
-                                    continue;
-                              e.setChannel(a.channel);
-                              int syntiIdx= score->midiMapping(a.channel)->articulation->synti;
-                              synti->play(e, syntiIdx);
+            memset(buffer, 0, sizeof(float) * FRAMES * 2);
+            int endTime = playTime + frames;
+            float* p = buffer;
+            for (; playPos != events.constEnd(); ++playPos) {
+                  int f = score->utick2utime(playPos->tick()) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  synti->process(n, p);
+                  p         += 2 * n;
+
+                  playTime  += n;
+                  frames    -= n;
+                  const PlayEvent& e = *playPos;
+                  if (e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        Channel* c = score->midiMapping(channelIdx)->articulation;
+                        if (!c->mute) {
+                              synti->play(e, c->synti);
                               }
                         }
                   }
+            if (frames) {
+                  synti->process(frames, p);
+                  playTime += frames;
+                  }
+            for (unsigned i = 0; i < FRAMES * 2; ++i)
+                  peak = qMax(peak, qAbs(buffer[i]));
+            if (spill.write((const char*)buffer, sizeof(buffer)) != sizeof(buffer)) {
+                  qDebug("write audio spill file failed\n");
+                  ok = false;
+                  break;
+                  }
+            playTime = endTime;
+            pBar->setValue(playTime);
+            if (playTime >= et)
+                  break;
+            }
 
-            static const unsigned FRAMES = 512;
-            float buffer[FRAMES * 2];
-            int playTime = 0;
-            synti->setGain(gain);
-
+      //
+      // normalize and encode
+      //
+      if (ok) {
+            float gain = peak > 0.0 ? 0.99 / peak : 1.0;
+            spill.seek(0);
+            int frames = 0;
             for (;;) {
-                  unsigned frames = FRAMES;
-                  //
-                  // collect events for one segment
-                  //
-                  memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                  int endTime = playTime + frames;
-                  float* p = buffer;
-                  for (; playPos != events.constEnd(); ++playPos) {
-                        int f = score->utick2utime(playPos.key()) * MScore::sampleRate;
-                        if (f >= endTime)
-                              break;
-                        int n = f - playTime;
-                        synti->process(n, p);
-                        p         += 2 * n;
-
-                        playTime  += n;
-                        frames    -= n;
-                        const Event& e = playPos.value();
-                        if (e.isChannelEvent()) {
-                              int channelIdx = e.channel();
-                              Channel* c = score->midiMapping(channelIdx)->articulation;
-                              if (!c->mute) {
-                                    synti->play(e, c->synti);
-                                    }
-                              }
-                        }
-                  if (frames) {
-                        synti->process(frames, p);
-                        playTime += frames;
-                        }
-                  if (pass == 1)
-                        sf_writef_float(sf, buffer, FRAMES);
-                  else {
-                        for (unsigned i = 0; i < FRAMES * 2; ++i)
-                              peak = qMax(peak, qAbs(buffer[i]));
-                        }
-                  playTime = endTime;
-                  pBar->setValue(playTime);
-                  if (playTime >= et)
+                  qint64 n = spill.read((char*)buffer, sizeof(buffer));
+                  if (n <= 0)
                         break;
+                  unsigned samples = n / sizeof(float);
+                  for (unsigned i = 0; i < samples; ++i)
+                        buffer[i] *= gain;
+                  sf_writef_float(sf, buffer, samples / 2);
+                  frames += samples / 2;
+                  pBar->setValue(frames);
                   }
-            gain = 0.99 / peak;
             }
 
       hideProgressBar();
@@ -163,7 +196,7 @@ bool MuseScore::saveAudio(Score* score, const QString& name, const QString& ext)
             return false;
             }
 
-      return true;
+      return ok;
       }
 
 #endif // HAS_AUDIOFILE
@@ -699,7 +699,7 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
             playPos = events.constBegin();
             EventMap::const_iterator endPos = events.constEnd();
             --endPos;
-            double et = score->utick2utime(endPos.key());
+            double et = score->utick2utime(endPos->tick());
             et += 1.0;   // add trailer (sec)
             pBar->setRange(0, int(et));
 
@@ -714,6 +714,7 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
                                     continue;
                               e.setChannel(a.channel);
                               int syntiIdx= score->midiMapping(a.channel)->articulation->synti;
+                              synti->prepare(e, syntiIdx);
                               synti->play(e, syntiIdx);
                               }
                         }
@@ -735,7 +736,7 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
                   float* r = bufferR;
 
                   for (; playPos != events.constEnd(); ++playPos) {
-                        double f = score->utick2utime(playPos.key());
+                        double f = score->utick2utime(playPos->tick());
                         if (f >= endTime)
                               break;
                         int n = lrint((f - playTime) * sampleRate);
@@ -752,7 +753,7 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
                               playTime += double(n)/double(sampleRate);
                               frames    -= n;
                               }
-                        const Event& e = playPos.value();
+                        const PlayEvent& e = *playPos;
                         if (e.isChannelEvent()) {
                               int channelIdx = e.channel();
                               Channel* c = score->midiMapping(channelIdx)->articulation;
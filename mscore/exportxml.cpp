@@ -737,16 +737,24 @@ static void findTrills(Measure* measure, int strack, int etrack, TrillHash& tril
 //---------------------------------------------------------
 
 typedef QList<int> IntVector;
-static IntVector integers;
-static IntVector primes;
+
+// per thread: part scores are exported concurrently
+static QThreadStorage<IntVector*> divisionIntegers;
+
+static IntVector& integers()
+      {
+      if (!divisionIntegers.hasLocalData())
+            divisionIntegers.setLocalData(new IntVector);
+      return *divisionIntegers.localData();
+      }
 
 // check if all integers can be divided by d
 
 static bool canDivideBy(int d)
       {
       bool res = true;
-      for (int i = 0; i < integers.count(); i++) {
-            if ((integers[i] <= 1) || ((integers[i] % d) != 0)) {
+      for (int i = 0; i < integers().count(); i++) {
+            if ((integers()[i] <= 1) || ((integers()[i] % d) != 0)) {
                   res = false;
                   }
             }
@@ -757,15 +765,15 @@ static bool canDivideBy(int d)
 
 static void divideBy(int d)
       {
-      for (int i = 0; i < integers.count(); i++) {
-            integers[i] /= d;
+      for (int i = 0; i < integers().count(); i++) {
+            integers()[i] /= d;
             }
       }
 
 static void addInteger(int len)
       {
-      if (!integers.contains(len)) {
-            integers.append(len);
+      if (!integers().contains(len)) {
+            integers().append(len);
             }
       }
 
@@ -819,12 +827,9 @@ static bool isTwoNoteTremolo(Chord* chord)
 void ExportMusicXml::calcDivisions()
       {
       // init
-      integers.clear();
-      primes.clear();
-      integers.append(MScore::division);
-      primes.append(2);
-      primes.append(3);
-      primes.append(5);
+      static const int primes[] = { 2, 3, 5 };
+      integers().clear();
+      integers().append(MScore::division);
 
       const QList<Part*>& il = score->parts();
 
@@ -885,13 +890,13 @@ void ExportMusicXml::calcDivisions()
             }
 
       // do it: divide by all primes as often as possible
-      for (int u = 0; u < primes.count(); u++)
+      for (unsigned u = 0; u < sizeof(primes)/sizeof(*primes); u++)
             while (canDivideBy(primes[u]))
                   divideBy(primes[u]);
 
-      div = MScore::division / integers[0];
+      div = MScore::division / integers()[0];
 #ifdef DEBUG_TICK
-      qDebug("divisions=%d div=%d", integers[0], div);
+      qDebug("divisions=%d div=%d", integers()[0], div);
 #endif
       }
 
@@ -1561,6 +1561,177 @@ bool MuseScore::exportFile()
       return saveAs(cs, true, fn, ext);
       }
 
+//---------------------------------------------------------
+//   PartExport
+//    one part score of exportPartScores()
+//---------------------------------------------------------
+
+struct PartExport {
+      Score* score;
+      QString fn;
+      QString ext;
+      bool ok;
+      qint64 layoutTime;      // ms
+      qint64 exportTime;
+      QAtomicInt* done;
+      QSemaphore* finished;   // released when the part is written
+      int parts;
+      };
+
+//---------------------------------------------------------
+//   concurrentExport
+//    true for formats which are written from a worker
+//    thread; the others need the gui or the synthesizer.
+//    Midi export rebuilds the repeat list shared by all
+//    parts through the root score and is written serially.
+//---------------------------------------------------------
+
+bool concurrentExport(const QString& ext)
+      {
+      static const char* formats[] = { "xml", "mxl", "pdf", "ps", "png", "svg" };
+      for (unsigned i = 0; i < sizeof(formats)/sizeof(*formats); ++i) {
+            if (ext == formats[i])
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   layoutPart
+//---------------------------------------------------------
+
+static void layoutPart(PartExport& pe)
+      {
+      QElapsedTimer t;
+      t.start();
+      pe.score->end2();       // deferred or never laid out since it was read
+      pe.layoutTime = t.elapsed();
+      }
+
+//---------------------------------------------------------
+//   exportPart
+//---------------------------------------------------------
+
+static void exportPart(PartExport& pe)
+      {
+      layoutPart(pe);
+      QElapsedTimer t;
+      t.start();
+      const QString& ext = pe.ext;
+      if (ext == "xml")
+            pe.ok = saveXml(pe.score, pe.fn);
+      else if (ext == "mxl")
+            pe.ok = saveMxl(pe.score, pe.fn);
+      else if (ext == "pdf")
+            pe.ok = mscore->savePsPdf(pe.score, pe.fn, QPrinter::PdfFormat);
+#if QT_VERSION < 0x050000
+      else if (ext == "ps")
+            pe.ok = mscore->savePsPdf(pe.score, pe.fn, QPrinter::PostScriptFormat);
+#endif
+      else if (ext == "png")
+            pe.ok = mscore->savePng(pe.score, pe.fn);
+      else if (ext == "svg")
+            pe.ok = mscore->saveSvg(pe.score, pe.fn);
+      pe.exportTime = t.elapsed();
+      if (noGui) {
+            fprintf(stderr, "part %d/%d %s: layout %lld ms, export %lld ms%s\n",
+               pe.done->fetchAndAddOrdered(1) + 1, pe.parts, qPrintable(pe.fn),
+               pe.layoutTime, pe.exportTime, pe.ok ? "" : " FAILED");
+            }
+      pe.finished->release();
+      }
+
+//---------------------------------------------------------
+//   exportPartScores
+//    write every part score of score to
+//    <base>-<part name>.<ext>. Layout and export run on
+//    the thread pool, progress and times per part go to
+//    the progress bar or, without gui, to stderr.
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::exportPartScores(Score* score, const QString& base, const QString& ext)
+      {
+      QAtomicInt done(0);
+      QSemaphore finished;
+      QList<PartExport> parts;
+      foreach(Excerpt* e, score->excerpts()) {
+            if (e->score() == 0)
+                  continue;
+            PartExport pe;
+            pe.score      = e->score();
+            pe.fn         = base + "-" + pe.score->name();
+            pe.ext        = ext;
+            pe.ok         = false;
+            pe.layoutTime = 0;
+            pe.exportTime = 0;
+            pe.done       = &done;
+            pe.finished   = &finished;
+            if (QFileInfo(pe.fn).suffix() != ext)
+                  pe.fn += "." + ext;
+            if (synti)
+                  pe.score->setSyntiState(synti->state());
+            parts.append(pe);
+            }
+      if (parts.isEmpty())
+            return true;
+      for (int i = 0; i < parts.size(); ++i)
+            parts[i].parts = parts.size();
+
+      QElapsedTimer t;
+      t.start();
+      QProgressBar* pBar = 0;
+      if (!noGui) {
+            pBar = showProgressBar();
+            pBar->reset();
+            pBar->setRange(0, parts.size());
+            }
+      bool rv = true;
+      if (concurrentExport(ext)) {
+            // no event loop while the workers change the part
+            // scores; paint events and the autosave timer would
+            // read them. The progress bar repaints itself.
+            QFuture<void> future = QtConcurrent::map(parts, exportPart);
+            for (int i = 0; i < parts.size(); ++i) {
+                  finished.acquire();
+                  if (pBar)
+                        pBar->setValue(i + 1);
+                  }
+            future.waitForFinished();
+            foreach(const PartExport& pe, parts)
+                  rv = rv && pe.ok;
+            }
+      else {
+            // lay out concurrently, write in this thread
+            QtConcurrent::blockingMap(parts, layoutPart);
+            for (int i = 0; i < parts.size(); ++i) {
+                  PartExport& pe = parts[i];
+                  QElapsedTimer et;
+                  et.start();
+                  pe.ok = saveAs(pe.score, true, pe.fn, ext);
+                  pe.exportTime = et.elapsed();
+                  if (pBar)
+                        pBar->setValue(i + 1);
+                  else {
+                        fprintf(stderr, "part %d/%d %s: layout %lld ms, export %lld ms%s\n",
+                           i + 1, parts.size(), qPrintable(pe.fn),
+                           pe.layoutTime, pe.exportTime, pe.ok ? "" : " FAILED");
+                        }
+                  if (!pe.ok) {
+                        rv = false;
+                        break;
+                        }
+                  }
+            }
+      foreach(const PartExport& pe, parts)
+            pe.score->flushViewers();
+      if (pBar)
+            hideProgressBar();
+      if (noGui)
+            fprintf(stderr, "%d parts, %lld ms\n", parts.size(), t.elapsed());
+      return rv;
+      }
+
 //---------------------------------------------------------
 //   exportParts
 //    return true on success
@@ -1609,37 +1780,28 @@ bool MuseScore::exportParts()
       if (thisScore->parentScore())
             thisScore = thisScore->parentScore();
 
-      foreach(Excerpt* e, thisScore->excerpts())  {
-            Score* pScore = e->score();
-            QString partfn = fn + QDir::separator() + thisScore->name() + "-" + pScore->name();
-            QFileInfo fi(partfn);
-            QString ext;
-            if (selectedFilter.isEmpty())
-                  ext = fi.suffix();
-            else {
-                  int idx = fl.indexOf(selectedFilter);
-                  if (idx != -1) {
-                        static const char* extensions[] = {
-                              "mscx", "xml", "mxl", "mid", "pdf", "ps", "png", "svg", "ly",
+      QString ext;
+      if (selectedFilter.isEmpty())
+            ext = QFileInfo(fn).suffix();
+      else {
+            int idx = fl.indexOf(selectedFilter);
+            if (idx != -1) {
+                  static const char* extensions[] = {
+                        "mscx", "xml", "mxl", "mid", "pdf", "ps", "png", "svg", "ly",
 #ifdef HAS_AUDIOFILE
-                              "wav", "flac", "ogg",
+                        "wav", "flac", "ogg",
 #endif
-                              "mp3"
-                              };
-                        ext = extensions[idx];
-                        }
-                  }
-            if (ext.isEmpty()) {
-                  QMessageBox::critical(this, tr("MuseScore: Export Parts"), tr("cannot determine file type"));
-                  return false;
+                        "mp3"
+                        };
+                  ext = extensions[idx];
                   }
-
-            if (fi.suffix() != ext)
-                  partfn += "." + ext;
-
-            if (!saveAs(pScore, true, partfn, ext))
-                  return false;
             }
+      if (ext.isEmpty()) {
+            QMessageBox::critical(this, tr("MuseScore: Export Parts"), tr("cannot determine file type"));
+            return false;
+            }
+      if (!exportPartScores(thisScore, fn + QDir::separator() + thisScore->name(), ext))
+            return false;
       QMessageBox::information(this, tr("MuseScore: Export Parts"), tr("Parts were successfully exported"));
       return true;
       }
@@ -1651,6 +1813,7 @@ bool MuseScore::exportParts()
 bool MuseScore::saveAs(Score* cs, bool saveCopy, const QString& path, const QString& ext)
       {
       cs->setSyntiState(synti->state());
+      cs->doDeferredLayout();       // part scores without a view are not laid out on edit
 
       bool rv = false;
       QString suffix = "." + ext;
@@ -2082,72 +2245,106 @@ bool MuseScore::savePng(Score* score, const QString& name)
       }
 
 //---------------------------------------------------------
-//   savePng with options
-//    return true on success
+//   PngPage
+//    paint, convert and encode one page; runs on a
+//    worker thread
 //---------------------------------------------------------
 
-bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, QImage::Format format)
-      {
-      bool rv = true;
-      score->setPrinting(!screenshot);    // dont print page break symbols etc.
+struct PngPage {
+      typedef QByteArray result_type;
+      bool transparent;
+      double dpi;
+      QImage::Format format;
+
+      PngPage(bool t, double d, QImage::Format f) : transparent(t), dpi(d), format(f) {}
+      QByteArray operator()(Page* page) const;
+      };
 
+QByteArray PngPage::operator()(Page* page) const
+      {
       QImage::Format f;
       if (format != QImage::Format_Indexed8)
           f = format;
       else
           f = QImage::Format_ARGB32_Premultiplied;
 
-      const QList<Page*>& pl = score->pages();
-      int pages = pl.size();
+      QRectF r = page->abbox();
+      int w = lrint(r.width()  * dpi / MScore::DPI);
+      int h = lrint(r.height() * dpi / MScore::DPI);
 
-      int padding = QString("%1").arg(pages).size();
-      for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
-            Page* page = pl.at(pageNumber);
+      QImage printer(w, h, f);
+      printer.setDotsPerMeterX(lrint((dpi * 1000) / INCH));
+      printer.setDotsPerMeterY(lrint((dpi * 1000) / INCH));
 
-            QRectF r = page->abbox();
-            int w = lrint(r.width()  * convDpi / MScore::DPI);
-            int h = lrint(r.height() * convDpi / MScore::DPI);
+      printer.fill(transparent ? 0 : 0xffffffff);
 
-            QImage printer(w, h, f);
-            printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
-            printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
+      double mag = dpi / MScore::DPI;
+      QPainter p(&printer);
 
-            printer.fill(transparent ? 0 : 0xffffffff);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(mag, mag);
 
-            double mag = convDpi / MScore::DPI;
-            QPainter p(&printer);
+      paintElements(p, page->elements());
+      p.end();
 
-            p.setRenderHint(QPainter::Antialiasing, true);
-            p.setRenderHint(QPainter::TextAntialiasing, true);
-            p.scale(mag, mag);
+      if (format == QImage::Format_Indexed8) {
+            //convert to grayscale & respect alpha
+            QVector<QRgb> colorTable;
+            colorTable.push_back(QColor(0, 0, 0, 0).rgba());
+            if (!transparent) {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(i, i, i).rgb());
+                  }
+            else {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(0, 0, 0, i).rgba());
+                  }
+            printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
+            }
 
-            paintElements(p, page->elements());
+      QByteArray data;
+      QBuffer buffer(&data);
+      buffer.open(QIODevice::WriteOnly);
+      if (!printer.save(&buffer, "png"))
+            data.clear();
+      return data;
+      }
 
-            if (format == QImage::Format_Indexed8) {
-                  //convert to grayscale & respect alpha
-                  QVector<QRgb> colorTable;
-                  colorTable.push_back(QColor(0, 0, 0, 0).rgba());
-                  if (!transparent) {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(i, i, i).rgb());
-                        }
-                  else {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(0, 0, 0, i).rgba());
-                        }
-                  printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
-                  }
+//---------------------------------------------------------
+//   savePng with options
+//    pages are painted and encoded in parallel and
+//    written in page order
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, QImage::Format format)
+      {
+      bool rv = true;
+      score->setPrinting(!screenshot);    // dont print page break symbols etc.
+
+      const QList<Page*>& pl = score->pages();
+      int pages = pl.size();
+      QFuture<QByteArray> png = QtConcurrent::mapped(pl, PngPage(transparent, convDpi, format));
+
+      int padding = QString("%1").arg(pages).size();
+      for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
+            QByteArray data = png.resultAt(pageNumber);
 
             QString fileName(name);
             if (fileName.endsWith(".png"))
                   fileName = fileName.left(fileName.size() - 4);
             fileName += QString("-%1.png").arg(pageNumber+1, padding, 10, QLatin1Char('0'));
 
-            rv = printer.save(fileName, "png");
-            if (!rv)
+            QFile f(fileName);
+            rv = !data.isEmpty() && f.open(QIODevice::WriteOnly) && f.write(data) == data.size();
+            if (!rv) {
+                  png.cancel();
                   break;
+                  }
             }
-      cs->setPrinting(false);
+      png.waitForFinished();
+      score->setPrinting(false);
       return rv;
       }
 
@@ -2259,7 +2456,7 @@ bool MuseScore::saveSvg(Score* score, const QString& saveName)
       printer.setTitle(title);
       printer.setDescription(QString("Generated by MuseScore %1").arg(VERSION));
       printer.setFileName(saveName);
-      const PageFormat* pf = cs->pageFormat();
+      const PageFormat* pf = score->pageFormat();
       double mag = converterDpi / MScore::DPI;
 
       qreal w = pf->width() * MScore::DPI * score->pages().size();
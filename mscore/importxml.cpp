@@ -102,6 +102,17 @@
 #include "libmscore/drumset.h"
 #include "libmscore/beam.h"
 
+extern bool noGui;
+
+//---------------------------------------------------------
+//   musicXmlValidateEvery
+//    validate every n-th imported MusicXML file against
+//    the schema, 0 disables validation
+//---------------------------------------------------------
+
+int musicXmlValidateEvery = 1;
+static QAtomicInt importCount;
+
 //---------------------------------------------------------
 //   local defines for debug output
 //---------------------------------------------------------
@@ -487,18 +498,27 @@ MusicXml::MusicXml(QDomDocument* d)
 
 
 //---------------------------------------------------------
-//   initMusicXmlSchema
-//    return false on error
+//   musicXmlSchema
+//    compile the MusicXML schema once per process,
+//    return 0 on error
 //---------------------------------------------------------
 
-static bool initMusicXmlSchema(QXmlSchema& schema)
+static const QXmlSchema* musicXmlSchema()
       {
+      static QMutex mutex;
+      static QXmlSchema* schema = 0;
+      static bool failed = false;
+
+      QMutexLocker locker(&mutex);
+      if (schema || failed)
+            return schema;
+      failed = true;
+
       // read the MusicXML schema from the application resources
       QFile schemaFile(":/schema/musicxml.xsd");
       if (!schemaFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qDebug("initMusicXmlSchema() could not open resource musicxml.xsd");
-            MScore::lastError = QT_TRANSLATE_NOOP("file", "internal error: could not open resource musicxml.xsd\n");
-            return false;
+            qDebug("musicXmlSchema() could not open resource musicxml.xsd");
+            return 0;
             }
 
       // copy the schema into a QByteArray and fixup xs:imports,
@@ -515,17 +535,19 @@ static bool initMusicXmlSchema(QXmlSchema& schema)
             }
 
       // load and validate the schema
-      schema.load(schemaBa);
-      if (!schema.isValid()) {
-            qDebug("initMusicXmlSchema() internal error: MusicXML schema is invalid");
-            MScore::lastError = QT_TRANSLATE_NOOP("file", "internal error: MusicXML schema is invalid\n");
-            return false;
+      QXmlSchema* s = new QXmlSchema;
+      s->setMessageHandler(new ValidatorMessageHandler);
+      s->load(schemaBa);
+      if (!s->isValid()) {
+            qDebug("musicXmlSchema() internal error: MusicXML schema is invalid");
+            delete s;
+            return 0;
             }
-
-      return true;
+      schema = s;
+      failed = false;
+      return schema;
       }
 
-
 //---------------------------------------------------------
 //   musicXMLValidationErrorDialog
 //---------------------------------------------------------
@@ -606,6 +628,64 @@ static bool extractRootfile(QFile* qf, QByteArray& data)
       }
 
 
+//---------------------------------------------------------
+//   validateAndImport
+//    validate and parse the MusicXML document in data,
+//    which is read only once, and import it into score
+//---------------------------------------------------------
+
+static Score::FileError validateAndImport(Score* score, const QString& name, const QByteArray& data, bool compressed)
+      {
+      int every = musicXmlValidateEvery;
+      if (every > 0 && (importCount.fetchAndAddRelaxed(1) % every) == 0) {
+            const QXmlSchema* schema = musicXmlSchema();
+            if (!schema) {
+                  MScore::lastError = QT_TRANSLATE_NOOP("file", "internal error: MusicXML schema is invalid\n");
+                  return Score::FILE_BAD_FORMAT;
+                  }
+
+            // validate the file
+            ValidatorMessageHandler messageHandler;
+            QXmlSchemaValidator validator(*schema);
+            validator.setMessageHandler(&messageHandler);
+            if (validator.validate(data, QUrl::fromLocalFile(name)))
+                  qDebug("importMusicXml() file '%s' is a valid %sMusicXML file", qPrintable(name), compressed ? "compressed " : "");
+            else {
+                  qDebug("importMusicXml() file '%s' is not a valid %sMusicXML file", qPrintable(name), compressed ? "compressed " : "");
+                  if (compressed)
+                        MScore::lastError = QT_TRANSLATE_NOOP("file", "this is not a valid compressed MusicXML file\n");
+                  else
+                        MScore::lastError = QT_TRANSLATE_NOOP("file", "this is not a valid MusicXML file\n");
+                  // without a gui nobody can be asked, try to load the file anyway
+                  if (noGui)
+                        qDebug("%s", qPrintable(messageHandler.getErrors()));
+                  else {
+                        QString text = compressed
+                           ? QString("File '%1' is not a valid compressed MusicXML file").arg(name)
+                           : QString("File '%1' is not a valid MusicXML file").arg(name);
+                        if (musicXMLValidationErrorDialog(text, messageHandler.getErrors()) != QMessageBox::Yes)
+                              return Score::FILE_USER_ABORT;
+                        }
+                  }
+            }
+
+      // finally load the file
+      QDomDocument doc;
+      int line, column;
+      QString err;
+      if (!doc.setContent(data, false, &err, &line, &column)) {
+            QString s = QT_TRANSLATE_NOOP("file", "error at line %1 column %2: %3\n");
+            MScore::lastError = s.arg(line).arg(column).arg(err);
+            return Score::FILE_BAD_FORMAT;
+            }
+      docName = name;
+      MusicXml musicxml(&doc);
+      musicxml.import(score);
+      qDebug("importMusicXml() return FILE_NO_ERROR");
+      return Score::FILE_NO_ERROR;
+      }
+
+
 //---------------------------------------------------------
 //   importMusicXml
 //    return false on error
@@ -626,41 +706,8 @@ Score::FileError importMusicXml(Score* score, const QString& name)
             MScore::lastError = QT_TRANSLATE_NOOP("file", "could not open MusicXML file\n");
             return Score::FILE_OPEN_ERROR;
             }
-
-      // initialize the schema
-      ValidatorMessageHandler messageHandler;
-      QXmlSchema schema;
-      schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
-
-      // validate the file
-      QXmlSchemaValidator validator(schema);
-      if (validator.validate(&xmlFile, QUrl::fromLocalFile(name)))
-            qDebug("importMusicXml() file '%s' is a valid MusicXML file", qPrintable(name));
-      else {
-            qDebug("importMusicXml() file '%s' is not a valid MusicXML file", qPrintable(name));
-            MScore::lastError = QT_TRANSLATE_NOOP("file", "this is not a valid MusicXML file\n");
-            QString text = QString("File '%1' is not a valid MusicXML file").arg(name);
-            if (musicXMLValidationErrorDialog(text, messageHandler.getErrors()) != QMessageBox::Yes)
-                  return Score::FILE_USER_ABORT;
-            }
-
-      // finally load the file
-      xmlFile.seek(0);
-      QDomDocument doc;
-      int line, column;
-      QString err;
-      if (!doc.setContent(&xmlFile, false, &err, &line, &column)) {
-            QString s = QT_TRANSLATE_NOOP("file", "error at line %1 column %2: %3\n");
-            MScore::lastError = s.arg(line).arg(column).arg(err);
-            return Score::FILE_BAD_FORMAT;
-            }
-      docName = xmlFile.fileName();
-      MusicXml musicxml(&doc);
-      musicxml.import(score);
-      qDebug("importMusicXml() return FILE_NO_ERROR");
-      return Score::FILE_NO_ERROR;
+      QByteArray data = xmlFile.readAll();
+      return validateAndImport(score, xmlFile.fileName(), data, false);
       }
 
 
@@ -689,39 +736,7 @@ Score::FileError importCompressedMusicXml(Score* score, const QString& name)
       if (!extractRootfile(&mxlFile, data))
             return Score::FILE_BAD_FORMAT;  // appropriate error message has been printed by extractRootfile
 
-      // initialize the schema
-      ValidatorMessageHandler messageHandler;
-      QXmlSchema schema;
-      schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
-
-      // validate the file
-      QXmlSchemaValidator validator(schema);
-      if (validator.validate(data, QUrl::fromLocalFile(name)))
-            qDebug("importMusicXml() file '%s' is a valid compressed MusicXML file", qPrintable(name));
-      else {
-            qDebug("importMusicXml() file '%s' is not a valid compressed MusicXML file", qPrintable(name));
-            MScore::lastError = QT_TRANSLATE_NOOP("file", "this is not a valid compressed MusicXML file\n");
-            QString text = QString("File '%1' is not a valid compressed MusicXML file").arg(name);
-            if (musicXMLValidationErrorDialog(text, messageHandler.getErrors()) != QMessageBox::Yes)
-                  return Score::FILE_USER_ABORT;
-            }
-
-      // finally load the file
-      QDomDocument doc;
-      int line, column;
-      QString err;
-      if (!doc.setContent(data, false, &err, &line, &column)) {
-            QString s = QT_TRANSLATE_NOOP("file", "error at line %1 column %2: %3\n");
-            MScore::lastError = s.arg(line).arg(column).arg(err);
-            return Score::FILE_BAD_FORMAT;
-            }
-      docName = mxlFile.fileName();
-      MusicXml musicxml(&doc);
-      musicxml.import(score);
-      qDebug("importMusicXml() return FILE_NO_ERROR");
-      return Score::FILE_NO_ERROR;
+      return validateAndImport(score, mxlFile.fileName(), data, true);
       }
 
 
@@ -33,6 +33,7 @@
 #include "mixer.h"
 #include "palette.h"
 #include "libmscore/part.h"
+#include "libmscore/excerpt.h"
 #include "libmscore/drumset.h"
 #include "libmscore/instrtemplate.h"
 #include "libmscore/note.h"
@@ -95,6 +96,10 @@ bool noGui = false;
 bool externalIcons = false;
 static bool pluginMode = false;
 static bool startWithNewScore = false;
+static bool startupTrace = false;
+static bool exportAllParts = false;
+static int validateEvery = -1;
+static QElapsedTimer startupTimer;
 double converterDpi = 0;
 
 QString mscoreGlobalShare;
@@ -102,12 +107,16 @@ static QStringList recentScores;
 static QString outFileName;
 static QString pluginName;
 static QString styleFile;
+static QString jobFile;
 QString localeName;
 bool useFactorySettings = false;
 QString styleName;
 QString revision;
 
 extern void initStaffTypes();
+extern Score::FileError readScore(Score* score, QString name, bool ignoreVersionError);
+extern int musicXmlValidateEvery;
+extern bool concurrentExport(const QString& ext);
 
 // Mac-Applications don't have menubar icons:
 #ifdef Q_WS_MAC
@@ -332,7 +341,7 @@ MuseScore::MuseScore()
       setWindowTitle(QString("MuseScore"));
       setIconSize(QSize(preferences.iconWidth, preferences.iconHeight));
 
-      ucheck                = new UpdateChecker();
+      ucheck                = noGui ? 0 : new UpdateChecker();
 
       setAcceptDrops(true);
       cs                    = 0;
@@ -991,16 +1000,26 @@ MuseScore::MuseScore()
 
       setCentralWidget(mainWindow);
 
-      // load cascading instrument templates
-      loadInstrumentTemplates(preferences.instrumentList1);
-      if (!preferences.instrumentList2.isEmpty())
-            loadInstrumentTemplates(preferences.instrumentList2);
+      // load cascading instrument templates; only the instrument
+      // dialogs and Score::appendPart(name) of plugins use them,
+      // the importers create their parts without templates
+      if (!converterMode || pluginMode) {
+            loadInstrumentTemplates(preferences.instrumentList1);
+            if (!preferences.instrumentList2.isEmpty())
+                  loadInstrumentTemplates(preferences.instrumentList2);
+            }
 
       preferencesChanged();
       if (seq) {
             connect(seq, SIGNAL(started()), SLOT(seqStarted()));
             connect(seq, SIGNAL(stopped()), SLOT(seqStopped()));
             }
+      autoSaveTimer = new QTimer(this);
+      autoSaveTimer->setSingleShot(true);
+      connect(autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSaveTimerTimeout()));
+      if (noGui)
+            return;
+
       loadScoreList();
 
       showPlayPanel(preferences.showPlayPanel);
@@ -1008,9 +1027,6 @@ MuseScore::MuseScore()
       QClipboard* cb = QApplication::clipboard();
       connect(cb, SIGNAL(dataChanged()), SLOT(clipboardChanged()));
       connect(cb, SIGNAL(selectionChanged()), SLOT(clipboardChanged()));
-      autoSaveTimer = new QTimer(this);
-      autoSaveTimer->setSingleShot(true);
-      connect(autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSaveTimerTimeout()));
       initOsc();
       startAutoSave();
       if (enableExperimental) {
@@ -1291,6 +1307,19 @@ void MuseScore::updateTabNames()
             }
       }
 
+//---------------------------------------------------------
+//   startupTime
+//    with -T print the time spent since the last
+//    checkpoint to stderr
+//---------------------------------------------------------
+
+static void startupTime(const char* what)
+      {
+      if (!startupTrace)
+            return;
+      fprintf(stderr, "startup: %-16s %6lld ms\n", what, startupTimer.restart());
+      }
+
 //---------------------------------------------------------
 //   usage
 //---------------------------------------------------------
@@ -1309,6 +1338,8 @@ static void usage()
         "   -I        dump midi input\n"
         "   -O        dump midi output\n"
         "   -o file   export to 'file'; format depends on file extension\n"
+        "   -P        with -o: also export every part to 'file-part'\n"
+        "   -j file   convert all jobs listed in 'file' in parallel\n"
         "   -r dpi    set output resolution for image export\n"
         "   -S style  load style file\n"
         "   -p name   execute named plugin\n"
@@ -1316,6 +1347,8 @@ static void usage()
         "   -i        load icons from INSTALLPATH/icons\n"
         "   -e        enable experimental features\n"
         "   -c dir    override config/settings directory\n"
+        "   -T        print startup time of every subsystem\n"
+        "   -X n      validate every n-th MusicXML file, 0 = never\n"
         );
       exit(-1);
       }
@@ -1969,6 +2002,97 @@ static void loadScores(const QStringList& argv)
       mscore->setCurrentView(1, currentScoreView);
       }
 
+//---------------------------------------------------------
+//   convertScore
+//    export cs to file fn; the format depends on the
+//    file extension
+//---------------------------------------------------------
+
+static bool convertScore(Score* cs, const QString& fn)
+      {
+      if (fn.endsWith(".mscx")) {
+            QFileInfo fi(fn);
+            try {
+                  cs->saveFile(fi);
+                  }
+            catch(QString) {
+                  return false;
+                  }
+            return true;
+            }
+      if (fn.endsWith(".mscz")) {
+            QFileInfo fi(fn);
+            try {
+                  cs->saveCompressedFile(fi, false);
+                  }
+            catch(QString) {
+                  return false;
+                  }
+            return true;
+            }
+      if (fn.endsWith(".xml"))
+            return saveXml(cs, fn);
+      if (fn.endsWith(".mxl"))
+            return saveMxl(cs, fn);
+      if (fn.endsWith(".mid"))
+            return mscore->saveMidi(cs, fn);
+      if (fn.endsWith(".pdf"))
+            return mscore->savePsPdf(cs, fn, QPrinter::PdfFormat);
+#if QT_VERSION < 0x050000
+      if (fn.endsWith(".ps"))
+            return mscore->savePsPdf(cs, fn, QPrinter::PostScriptFormat);
+#endif
+      if (fn.endsWith(".png"))
+            return mscore->savePng(cs, fn);
+      if (fn.endsWith(".svg"))
+            return mscore->saveSvg(cs, fn);
+      if (fn.endsWith(".ly"))
+            return mscore->saveLilypond(cs, fn);
+#ifdef HAS_AUDIOFILE
+      if (fn.endsWith(".wav"))
+            return mscore->saveAudio(cs, fn, "wav");
+      if (fn.endsWith(".ogg"))
+            return mscore->saveAudio(cs, fn, "ogg");
+      if (fn.endsWith(".flac"))
+            return mscore->saveAudio(cs, fn, "flac");
+#endif
+      if (fn.endsWith(".mp3"))
+            return mscore->saveMp3(cs, fn);
+      else {
+            qDebug("dont know how to convert to %s", qPrintable(fn));
+            return false;
+            }
+      }
+
+//---------------------------------------------------------
+//   createPartScores
+//    one part score per instrument for a score which
+//    defines no parts
+//---------------------------------------------------------
+
+static void createPartScores(Score* score)
+      {
+      QList<Excerpt*> excerpts;
+      QSet<QString> names;
+      foreach(Part* part, score->parts()) {
+            QString name = part->partName();
+            for (int n = 2; names.contains(name); ++n)
+                  name = QString("%1 %2").arg(part->partName()).arg(n);
+            names.insert(name);
+            Excerpt* e = new Excerpt(0);
+            e->parts().append(part);
+            e->setTitle(name);
+            excerpts.append(e);
+            }
+      ::createExcerpts(excerpts);     // clone and layout on the thread pool
+      foreach(Excerpt* e, excerpts) {
+            if (e->score())
+                  score->excerpts().append(e);
+            else
+                  delete e;
+            }
+      }
+
 //---------------------------------------------------------
 //   processNonGui
 //---------------------------------------------------------
@@ -2004,62 +2128,231 @@ static bool processNonGui()
                         cs->style()->load(&f);
                         }
                   }
-            if (fn.endsWith(".mscx")) {
+            if (!convertScore(cs, fn))
+                  return false;
+            if (exportAllParts) {
+                  if (cs->excerpts().isEmpty())
+                        createPartScores(cs);
                   QFileInfo fi(fn);
-                  try {
-                        cs->saveFile(fi);
-                        }
-                  catch(QString) {
-                        return false;
-                        }
-                  return true;
+                  return mscore->exportPartScores(cs, fi.path() + "/" + fi.completeBaseName(), fi.suffix());
                   }
-            if (fn.endsWith(".mscz")) {
-                  QFileInfo fi(fn);
-                  try {
-                        cs->saveCompressedFile(fi, false);
-                        }
-                  catch(QString) {
-                        return false;
-                        }
+            return true;
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   BatchJob
+//    one line of a job file:
+//    input <tab> output [<tab> output ...] [<tab> style.mss]
+//---------------------------------------------------------
+
+struct BatchJob {
+      QString in;
+      QStringList out;
+      QString style;
+
+      bool ok;
+      QString error;
+      qint64 loadTime;        // ms
+      qint64 layoutTime;
+      qint64 exportTime;
+
+      BatchJob() : ok(false), loadTime(0), layoutTime(0), exportTime(0) {}
+      bool hasAudio() const;
+      void run();
+      };
+
+//---------------------------------------------------------
+//   hasAudio
+//    audio export uses the progress bar and must run in
+//    the gui thread
+//---------------------------------------------------------
+
+bool BatchJob::hasAudio() const
+      {
+      foreach(const QString& fn, out) {
+            if (fn.endsWith(".wav") || fn.endsWith(".ogg") || fn.endsWith(".flac") || fn.endsWith(".mp3"))
                   return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   run
+//    reading is serialized, the importers share some
+//    global state; layout and export run in parallel.
+//    Only exporters which are known to be thread safe
+//    run concurrently, the others are serialized.
+//    Midi and native files only read the score of the
+//    job and are safe as well.
+//---------------------------------------------------------
+
+void BatchJob::run()
+      {
+      static QMutex readMutex;
+      static QMutex exportMutex;
+
+      QElapsedTimer t;
+      t.start();
+      Score* score = new Score(MScore::defaultStyle());
+      Score::FileError rv;
+      {
+      QMutexLocker locker(&readMutex);
+      rv = readScore(score, in, false);
+      if (rv != Score::FILE_NO_ERROR)
+            error = QString("read error %1 %2").arg(int(rv)).arg(MScore::lastError);
+      }
+      loadTime = t.restart();
+      if (rv != Score::FILE_NO_ERROR) {
+            delete score;
+            return;
+            }
+      if (!style.isEmpty()) {
+            QFile f(style);
+            if (f.open(QIODevice::ReadOnly))
+                  score->style()->load(&f);
+            }
+      score->doLayout();
+      layoutTime = t.restart();
+
+      ok = true;
+      foreach(const QString& fn, out) {
+            QString ext(QFileInfo(fn).suffix());
+            bool serial = !concurrentExport(ext) && ext != "mid" && ext != "mscx" && ext != "mscz";
+            if (serial)
+                  exportMutex.lock();
+            bool rv = convertScore(score, fn);
+            if (serial)
+                  exportMutex.unlock();
+            if (!rv) {
+                  ok = false;
+                  error = QString("cannot write %1").arg(fn);
+                  break;
                   }
-            if (fn.endsWith(".xml"))
-                  return saveXml(cs, fn);
-            if (fn.endsWith(".mxl"))
-                  return saveMxl(cs, fn);
-            if (fn.endsWith(".mid"))
-                  return mscore->saveMidi(cs, fn);
-            if (fn.endsWith(".pdf"))
-                  return mscore->savePsPdf(fn, QPrinter::PdfFormat);
-#if QT_VERSION < 0x050000
-            if (fn.endsWith(".ps"))
-                  return mscore->savePsPdf(fn, QPrinter::PostScriptFormat);
-#endif
-            if (fn.endsWith(".png"))
-                  return mscore->savePng(cs, fn);
-            if (fn.endsWith(".svg"))
-                  return mscore->saveSvg(cs, fn);
-            if (fn.endsWith(".ly"))
-                  return mscore->saveLilypond(cs, fn);
-#ifdef HAS_AUDIOFILE
-            if (fn.endsWith(".wav"))
-                  return mscore->saveAudio(cs, fn, "wav");
-            if (fn.endsWith(".ogg"))
-                  return mscore->saveAudio(cs, fn, "ogg");
-            if (fn.endsWith(".flac"))
-                  return mscore->saveAudio(cs, fn, "flac");
-#endif
-            if (fn.endsWith(".mp3"))
-                  return mscore->saveMp3(cs, fn);
-            else {
-                  qDebug("dont know how to convert to %s", qPrintable(outFileName));
-                  return false;
+            }
+      exportTime = t.elapsed();
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   BatchRunner
+//---------------------------------------------------------
+
+class BatchRunner : public QRunnable {
+      BatchJob* job;
+
+   public:
+      BatchRunner(BatchJob* j) : job(j) {}
+      virtual void run() { job->run(); }
+      };
+
+//---------------------------------------------------------
+//   readJobFile
+//    relative paths are relative to the job file
+//---------------------------------------------------------
+
+static bool readJobFile(const QString& path, QList<BatchJob*>* jobs)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qDebug("cannot open job file <%s>", qPrintable(path));
+            return false;
+            }
+      QDir dir(QFileInfo(path).absolutePath());
+      QTextStream ts(&f);
+      while (!ts.atEnd()) {
+            QString line = ts.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith('#'))
+                  continue;
+            QStringList fields = line.split('\t', QString::SkipEmptyParts);
+            BatchJob* job = new BatchJob;
+            job->in    = dir.absoluteFilePath(fields.takeFirst());
+            job->style = styleFile;
+            foreach(const QString& s, fields) {
+                  if (s.endsWith(".mss"))
+                        job->style = dir.absoluteFilePath(s);
+                  else
+                        job->out.append(dir.absoluteFilePath(s));
                   }
+            jobs->append(job);
             }
       return true;
       }
 
+//---------------------------------------------------------
+//   jsonString
+//---------------------------------------------------------
+
+static QString jsonString(const QString& s)
+      {
+      QString r("\"");
+      foreach(QChar c, s) {
+            if (c == '"' || c == '\\')
+                  r += '\\';
+            if (c.unicode() < 0x20)
+                  r += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+            else
+                  r += c;
+            }
+      r += '"';
+      return r;
+      }
+
+//---------------------------------------------------------
+//   processBatch
+//    convert all jobs of the job file on a thread pool;
+//    writes one json line per job to stdout
+//---------------------------------------------------------
+
+static bool processBatch(const QString& path)
+      {
+      QList<BatchJob*> jobs;
+      if (!readJobFile(path, &jobs))
+            return false;
+
+      // schema validation costs more than the import itself,
+      // check only a sample of a large corpus by default
+      if (validateEvery < 0)
+            musicXmlValidateEvery = 16;
+
+      QElapsedTimer t;
+      t.start();
+      QThreadPool pool;
+      QList<BatchJob*> audioJobs;
+      foreach(BatchJob* job, jobs) {
+            if (job->hasAudio())
+                  audioJobs.append(job);
+            else
+                  pool.start(new BatchRunner(job));
+            }
+      foreach(BatchJob* job, audioJobs)
+            job->run();
+      pool.waitForDone();
+
+      QTextStream out(stdout);
+      int failed = 0;
+      foreach(BatchJob* job, jobs) {
+            QStringList ol;
+            foreach(const QString& s, job->out)
+                  ol.append(jsonString(s));
+            out << "{\"in\":" << jsonString(job->in)
+                << ",\"out\":[" << ol.join(",") << "]"
+                << ",\"ok\":" << (job->ok ? "true" : "false")
+                << ",\"error\":" << jsonString(job->error)
+                << ",\"load\":" << job->loadTime
+                << ",\"layout\":" << job->layoutTime
+                << ",\"export\":" << job->exportTime
+                << "}\n";
+            if (!job->ok)
+                  ++failed;
+            delete job;
+            }
+      out.flush();
+      qDebug("%d jobs, %d failed, %lld ms", jobs.size(), failed, t.elapsed());
+      return failed == 0;
+      }
+
 //---------------------------------------------------------
 //   StartDialog
 //---------------------------------------------------------
@@ -2155,6 +2448,7 @@ int main(int argc, char* av[])
             exit(-1);
             }
 
+      startupTimer.start();
       QStringList argv =  QCoreApplication::arguments();
       argv.removeFirst();
 
@@ -2192,6 +2486,13 @@ int main(int argc, char* av[])
                   case 'O':
                         midiOutputTrace = true;
                         break;
+                  case 'j':
+                        converterMode = true;
+                        noGui = true;
+                        if (argv.size() - i < 2)
+                              usage();
+                        jobFile = argv.takeAt(i + 1);
+                        break;
                   case 'o':
                         converterMode = true;
                         noGui = true;
@@ -2199,6 +2500,9 @@ int main(int argc, char* av[])
                               usage();
                         outFileName = argv.takeAt(i + 1);
                         break;
+                  case 'P':
+                        exportAllParts = true;
+                        break;
                   case 'p':
                         pluginMode = true;
                         noGui = true;
@@ -2222,6 +2526,14 @@ int main(int argc, char* av[])
                   case 'e':
                         enableExperimental = true;
                         break;
+                  case 'T':
+                        startupTrace = true;
+                        break;
+                  case 'X':
+                        if (argv.size() - i < 2)
+                              usage();
+                        validateEvery = argv.takeAt(i + 1).toInt();
+                        break;
                   case 'c':
                         {
                         if (argv.size() - i < 2)
@@ -2240,6 +2552,8 @@ int main(int argc, char* av[])
                   }
             argv.removeAt(i);
             }
+      if (validateEvery >= 0)
+            musicXmlValidateEvery = validateEvery;
       mscoreGlobalShare = getSharePath();
       iconPath = externalIcons ? mscoreGlobalShare + QString("icons/") :  QString(":/data/");
       iconGroup = "icons-dark/";
@@ -2305,6 +2619,7 @@ int main(int argc, char* av[])
 
       if (converterDpi == 0)
             converterDpi = preferences.pngResolution;
+      startupTime("preferences");
 
       QSplashScreen* sc = 0;
       if (!noGui && preferences.showSplashScreen) {
@@ -2363,23 +2678,34 @@ int main(int argc, char* av[])
       //   _spatium    = SPATIUM20  * DPI;     // 20.0 / 72.0 * DPI / 4.0;
 
       genIcons();
+      startupTime("icons");
 
       if (!converterMode)
             qApp->setWindowIcon(*icons[window_ICON]);
       initProfile();
+
+      // headless runs never play: do not open audio/midi drivers
+      // and do not load sound fonts; audio export creates its
+      // own synthesizer when it is needed
+      if (noGui)
+            noSeq = true;
+
       mscore = new MuseScore();
       mscoreCore = mscore;
       gscore = new Score(MScore::defaultStyle());
+      startupTime("main window");
 
       if (!noSeq) {
             if (!seq->init()) {
                   qDebug("sequencer init failed");
                   noSeq = true;
                   }
+            startupTime("synthesizer");
             }
 
       //read languages list
       mscore->readLanguages(mscoreGlobalShare + "locale/languages.xml");
+      startupTime("languages");
 
 #ifdef Q_WS_MAC
       QApplication::instance()->installEventFilter(mscore);
@@ -2390,8 +2716,11 @@ int main(int argc, char* av[])
       mscore->setRevision(revision);
 
       int files = 0;
+      if (!jobFile.isEmpty())
+            exit(processBatch(jobFile) ? 0 : -1);
       if (noGui) {
             loadScores(argv);
+            startupTime("load scores");
             exit(processNonGui() ? 0 : -1);
             }
       else {
@@ -2419,7 +2748,9 @@ int main(int argc, char* av[])
                   loadScores(argv);
 #endif
             }
+      startupTime("session");
       mscore->loadPlugins();
+      startupTime("plugins");
       mscore->writeSessionFile(false);
 
 #ifdef Q_WS_MAC
@@ -2430,6 +2761,7 @@ int main(int argc, char* av[])
 
       mscore->changeState(mscore->noScore() ? STATE_DISABLED : STATE_NORMAL);
       mscore->show();
+      startupTime("show");
 
       if (sc)
             sc->finish(mscore);
@@ -573,6 +573,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void printFile();
       bool exportFile();
       bool exportParts();
+      bool exportPartScores(Score*, const QString& base, const QString& ext);
       bool saveAs(Score*, bool saveCopy, const QString& path, const QString& ext);
       bool savePsPdf(const QString& saveName, QPrinter::OutputFormat format);
       bool savePsPdf(Score* cs, const QString& saveName, QPrinter::OutputFormat format);
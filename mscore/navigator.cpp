@@ -27,6 +27,7 @@
 #include "libmscore/mscore.h"
 #include "libmscore/system.h"
 #include "libmscore/measurebase.h"
+#include "tilecache.h"
 
 //---------------------------------------------------------
 //   showNavigator
@@ -105,6 +106,8 @@ Navigator::Navigator(NScrollArea* sa, QWidget* parent)
       scrollArea     = sa;
       _cv            = 0;
       viewRect       = new ViewRect(this);
+      tiles          = new TileCache(64, this);
+      connect(tiles, SIGNAL(tileReady(const QRectF&)), SLOT(tileReady(const QRectF&)));
       setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
       sa->setWidget(this);
       sa->setWidgetResizable(false);
@@ -134,6 +137,7 @@ void Navigator::setScoreView(ScoreView* v)
             disconnect(_cv, SIGNAL(viewRectChanged()), this, SLOT(updateViewRect()));
             }
       _cv = QPointer<ScoreView>(v);
+      tiles->clear();
       if (v) {
             _score  = v->score();
             rescale();
@@ -157,6 +161,7 @@ void Navigator::setScore(Score* v)
       {
       _cv = 0;
       _score = v;
+      tiles->clear();
       rescale();
       setViewRect(QRect());
       update();
@@ -285,16 +290,23 @@ void Navigator::setViewRect(const QRectF& _viewRect)
       }
 
 //---------------------------------------------------------
-//   paintElement
+//   paintTile
+//    record the page rectangle r for the tile cache
 //---------------------------------------------------------
 
-static void paintElement(void* data, Element* e)
+void Navigator::paintTile(void*, QPainter& p, Page* page, const QRectF& r)
       {
-      QPainter* p = static_cast<QPainter*>(data);
-      QPointF pos(e->pagePos());
-      p->translate(pos);
-      e->draw(p);
-      p->translate(-pos);
+      QList<const Element*> el = page->items(r);
+      qStableSort(el.begin(), el.end(), elementLessThan);
+      foreach(const Element* e, el) {
+            e->itemDiscovered = 0;
+            if (!e->visible())
+                  continue;
+            QPointF pos(e->pagePos());
+            p.translate(pos);
+            e->draw(&p);
+            p.translate(-pos);
+            }
       }
 
 //---------------------------------------------------------
@@ -308,8 +320,39 @@ void Navigator::layoutChanged()
       update();
       }
 
+//---------------------------------------------------------
+//   dataChanged
+//---------------------------------------------------------
+
+void Navigator::dataChanged(const QRectF& r)
+      {
+      tiles->invalidate(_score, r);
+      update(matrix.mapRect(r).toAlignedRect());
+      }
+
+//---------------------------------------------------------
+//   updateAll
+//    page generations are updated by the score view
+//---------------------------------------------------------
+
+void Navigator::updateAll()
+      {
+      update();
+      }
+
+//---------------------------------------------------------
+//   tileReady
+//---------------------------------------------------------
+
+void Navigator::tileReady(const QRectF& r)
+      {
+      update(matrix.mapRect(r).toAlignedRect());
+      }
+
 //---------------------------------------------------------
 //   paintEvent
+//    pages are painted from cached thumbnails which are
+//    only rendered again if a page is laid out or changed
 //---------------------------------------------------------
 
 void Navigator::paintEvent(QPaintEvent* ev)
@@ -333,18 +376,15 @@ void Navigator::paintEvent(QPaintEvent* ev)
                   break;
 
             p.fillRect(pr, Qt::white);
-            p.translate(pos);
-            foreach(System* s, *page->systems()) {
-                  foreach(MeasureBase* m, s->measures())
-                        m->scanElements(&p, paintElement, false);
-                  }
-            page->scanElements(&p, paintElement, false);
-            if (page->score()->layoutMode() == LayoutPage) {
+            LayoutMode mode = page->score()->layoutMode();
+            tiles->draw(p, page, mode == LayoutLine ? fr : fr & pr, paintTile, 0);
+            if (mode == LayoutPage) {
+                  p.translate(pos);
                   p.setFont(QFont("FreeSans", 400));  // !!
                   p.setPen(QColor(0, 0, 255, 50));
                   p.drawText(page->bbox(), Qt::AlignCenter, QString("%1").arg(page->no()+1));
+                  p.translate(-pos);
                   }
-            p.translate(-pos);
             }
       }
 
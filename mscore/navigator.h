@@ -25,6 +25,7 @@ class Score;
 class ScoreView;
 class Page;
 class Navigator;
+class TileCache;
 
 //---------------------------------------------------------
 //   NScrollArea
@@ -68,8 +69,10 @@ class Navigator : public QWidget {
       ViewRect* viewRect;
       QPoint startMove;
       QTransform matrix;
+      TileCache* tiles;       ///< page thumbnails
 
       void rescale();
+      static void paintTile(void*, QPainter&, Page*, const QRectF&);
 
       virtual void paintEvent(QPaintEvent*);
       virtual void mousePressEvent(QMouseEvent*);
@@ -79,6 +82,11 @@ class Navigator : public QWidget {
    public slots:
       void updateViewRect();
       void layoutChanged();
+      void dataChanged(const QRectF&);
+      void updateAll();
+
+   private slots:
+      void tileReady(const QRectF&);
 
    signals:
       void viewRectMoved(const QRectF&);
@@ -58,6 +58,7 @@
 #include "libmscore/tablature.h"
 #include "libmscore/shadownote.h"
 #include "libmscore/sym.h"
+#include "tilecache.h"
 #include "libmscore/lasso.h"
 #include "libmscore/box.h"
 #include "libmscore/textframe.h"
@@ -645,6 +646,8 @@ ScoreView::ScoreView(QWidget* parent)
       _fgColor    = Qt::white;
       fgPixmap    = 0;
       bgPixmap    = 0;
+      tiles       = new TileCache(128, this);
+      connect(tiles, SIGNAL(tileReady(const QRectF&)), SLOT(tileReady(const QRectF&)));
       lasso       = new Lasso(_score);
       _foto       = new Lasso(_score);
 
@@ -911,6 +914,7 @@ void ScoreView::setScore(Score* s)
             _score->removeViewer(this);
       _score = s;
       _score->addViewer(this);
+      tiles->clear();
 
       if (shadowNote == 0) {
             shadowNote = new ShadowNote(_score);
@@ -1254,6 +1258,9 @@ void ScoreView::setForeground(const QColor& color)
 
 void ScoreView::dataChanged(const QRectF& r)
       {
+      tiles->invalidate(_score, r);
+      if (mscore->navigator() && mscore->navigator()->score() == _score)
+            mscore->navigator()->dataChanged(r);
       update(_matrix.mapRect(r).toRect());  // generate paint event
       }
 
@@ -1263,9 +1270,24 @@ void ScoreView::dataChanged(const QRectF& r)
 
 void ScoreView::updateAll()
       {
+      // only pages with changed content get a new generation,
+      // tiles of the other pages stay valid
+      foreach(Page* page, _score->pages())
+            page->updateGeneration();
+      if (mscore->navigator() && mscore->navigator()->score() == _score)
+            mscore->navigator()->updateAll();
       update();
       }
 
+//---------------------------------------------------------
+//   tileReady
+//---------------------------------------------------------
+
+void ScoreView::tileReady(const QRectF& r)
+      {
+      update(_matrix.mapRect(r).toAlignedRect());
+      }
+
 //---------------------------------------------------------
 //   moveCursor
 //---------------------------------------------------------
@@ -1693,12 +1715,8 @@ void ScoreView::paint(const QRect& r, QPainter& p)
       QRectF fr = imatrix.mapRect(QRectF(r));
 
       QRegion r1(r);
-      if (_score->layoutMode() == LayoutLine) {
-            Page* page = _score->pages().front();
-            QList<const Element*> ell = page->items(fr);
-            qStableSort(ell.begin(), ell.end(), elementLessThan);
-            drawElements(p, ell);
-            }
+      if (_score->layoutMode() == LayoutLine)
+            drawPage(p, _score->pages().front(), fr);
       else {
             foreach (Page* page, _score->pages()) {
                   if (!score()->printing())
@@ -1708,12 +1726,7 @@ void ScoreView::paint(const QRect& r, QPainter& p)
                         continue;
                   if (pr.left() > fr.right())
                         break;
-                  QList<const Element*> ell = page->items(fr.translated(-page->pos()));
-                  qStableSort(ell.begin(), ell.end(), elementLessThan);
-                  QPointF pos(page->pos());
-                  p.translate(pos);
-                  drawElements(p, ell);
-                  p.translate(-pos);
+                  drawPage(p, page, fr & pr);
                   r1 -= _matrix.mapRect(pr).toAlignedRect();
                   }
             }
@@ -2203,6 +2216,39 @@ static void drawDebugInfo(QPainter& p, const Element* e)
             }
       }
 
+//---------------------------------------------------------
+//   drawPage
+//    draw the canvas rectangle fr of page; outside of
+//    edit and drag operations cached tiles are used
+//---------------------------------------------------------
+
+void ScoreView::drawPage(QPainter& p, Page* page, const QRectF& fr)
+      {
+      if (!score()->printing() && !editMode() && !dragElement && !MScore::debugMode) {
+            tiles->draw(p, page, fr, paintTile, this);
+            return;
+            }
+      QPointF pos(page->pos());
+      QList<const Element*> ell = page->items(fr.translated(-pos));
+      qStableSort(ell.begin(), ell.end(), elementLessThan);
+      p.translate(pos);
+      drawElements(p, ell);
+      p.translate(-pos);
+      }
+
+//---------------------------------------------------------
+//   paintTile
+//    record the page rectangle r for the tile cache
+//---------------------------------------------------------
+
+void ScoreView::paintTile(void* data, QPainter& p, Page* page, const QRectF& r)
+      {
+      ScoreView* view = static_cast<ScoreView*>(data);
+      QList<const Element*> ell = page->items(r);
+      qStableSort(ell.begin(), ell.end(), elementLessThan);
+      view->drawElements(p, ell);
+      }
+
 //---------------------------------------------------------
 //   drawElements
 //---------------------------------------------------------
@@ -44,6 +44,7 @@ class Text;
 class MeasureBase;
 class Staff;
 class OmrView;
+class TileCache;
 
 enum {
       TEXT_TITLE,
@@ -190,9 +191,12 @@ class ScoreView : public QWidget, public MuseScoreView {
       QColor _fgColor;
       QPixmap* bgPixmap;
       QPixmap* fgPixmap;
+      TileCache* tiles;       ///< rendered page regions
 
       virtual void paintEvent(QPaintEvent*);
       void paint(const QRect&, QPainter&);
+      void drawPage(QPainter&, Page*, const QRectF&);
+      static void paintTile(void*, QPainter&, Page*, const QRectF&);
 
       void objectPopup(const QPoint&, Element*);
       void measurePopup(const QPoint&, Measure*);
@@ -275,6 +279,7 @@ class ScoreView : public QWidget, public MuseScoreView {
       void startFotoDrag();
       void endFotoDrag();
       void endFotoDragEdit();
+      void tileReady(const QRectF&);
 
    public slots:
       void setViewRect(const QRectF&);
@@ -489,7 +489,7 @@ void Seq::stop()
       if (cv)
             cv->setCursorOn(false);
       if (cs) {
-            cs->setPlayPos(playPos.key());
+            cs->setPlayPos(playPos->tick());
             cs->setLayoutAll(false);
             cs->setUpdateAll();
             cs->end();
@@ -593,11 +593,7 @@ void Seq::stopTransport()
             return;
       stopNotes();
       // send sustain off
-      Event e;
-      e.setType(ME_CONTROLLER);
-      e.setController(CTRL_SUSTAIN);
-      e.setValue(0);
-      putEvent(e);
+      putEvent(PlayEvent(0, ME_CONTROLLER, 0, CTRL_SUSTAIN, 0));
       emit toGui('0');
       }
 
@@ -618,7 +614,7 @@ void Seq::startTransport()
 //    send one event to the synthesizer
 //---------------------------------------------------------
 
-void Seq::playEvent(const Event& event)
+void Seq::playEvent(const PlayEvent& event)
       {
       int type = event.type();
       if (type == ME_NOTEON) {
@@ -653,14 +649,16 @@ void Seq::processMessages()
             switch(msg.id) {
                   case SEQ_TEMPO_CHANGE:
                         {
+                        // the gui thread has staged the time table
+                        // for the new tempo, switch tables and keep
+                        // the play position
                         if (playTime != 0) {
                               int tick = cs->utime2utick(qreal(playTime) / qreal(MScore::sampleRate));
-                              cs->tempomap()->setRelTempo(msg.data.realVal);
-                              cs->repeatList()->update();
+                              cs->repeatList()->commitTimeTable();
                               playTime = cs->utick2utime(tick) * MScore::sampleRate;
                               }
                         else
-                              cs->tempomap()->setRelTempo(msg.data.realVal);
+                              cs->repeatList()->commitTimeTable();
                         }
                         break;
                   case SEQ_PLAY:
@@ -738,12 +736,12 @@ void Seq::process(unsigned n, float* buffer)
             unsigned framePos = 0;
             int endTime = playTime + frames;
             for (; playPos != events.constEnd(); ++playPos) {
-                  int f = cs->utick2utime(playPos.key()) * MScore::sampleRate;
+                  int f = cs->utick2utime(playPos->tick()) * MScore::sampleRate;
                   if (f >= endTime)
                         break;
                   int n = f - playTime;
                   if (n < 0) {
-                        qDebug("%d:  %d - %d\n", playPos.key(), f, playTime);
+                        qDebug("%d:  %d - %d\n", playPos->tick(), f, playTime);
       			n = 0;
                         }
                   if (n) {
@@ -773,7 +771,7 @@ void Seq::process(unsigned n, float* buffer)
                                     }
                               }
                         }
-                  const Event& event = playPos.value();
+                  const PlayEvent& event = *playPos;
                   playEvent(event);
                   if (event.type() == ME_TICK1)
                         tickRest = tickLength;
@@ -813,6 +811,8 @@ void Seq::process(unsigned n, float* buffer)
       else {
             synti->process(frames, p);
             }
+      if (cs)
+            cs->repeatList()->ackTimeTable();
       //
       // metering
       //
@@ -867,7 +867,7 @@ void Seq::collectEvents()
       if (!events.empty()) {
             EventMap::const_iterator e = events.constEnd();
             --e;
-            endTick = e.key();
+            endTick = e->tick();
             }
 
       PlayPanel* pp = mscore->getPlayPanel();
@@ -917,12 +917,18 @@ void Seq::processToGuiMessages()
 
 void Seq::setRelTempo(double relTempo)
       {
-      SeqMsg msg;
-      msg.data.realVal = relTempo;
-      msg.id    = SEQ_TEMPO_CHANGE;
-      guiToSeq(msg);
+      cs->tempomap()->setRelTempo(relTempo);
+      if (driver && running) {
+            cs->repeatList()->stageUpdate();
+            SeqMsg msg;
+            msg.data.realVal = relTempo;
+            msg.id    = SEQ_TEMPO_CHANGE;
+            guiToSeq(msg);
+            }
+      else
+            cs->repeatList()->update();
 
-      double t = cs->tempomap()->tempo(playPos.key()) * relTempo;
+      double t = cs->tempomap()->tempo(playPos->tick()) * relTempo;
 
       PlayPanel* pp = mscore->getPlayPanel();
       if (pp) {
@@ -1057,6 +1063,8 @@ void Seq::setController(int channel, int ctrl, int data)
 
 void Seq::sendEvent(const Event& ev)
       {
+      if (cs && ev.type() == ME_CONTROLLER)
+            synti->prepare(ev, cs->midiMapping(ev.channel())->articulation->synti);
       SeqMsg msg;
       msg.id    = SEQ_PLAY;
       msg.event = ev;
@@ -1072,8 +1080,8 @@ void Seq::nextMeasure()
       EventMap::const_iterator i = playPos;
       const Note* note = 0;
       for (;;) {
-            if (i.value().type() == ME_NOTEON) {
-                  const Event& n = i.value();
+            if (i->type() == ME_NOTEON) {
+                  const PlayEvent& n = *i;
                   note = n.note();
                   break;
                   }
@@ -1087,7 +1095,7 @@ void Seq::nextMeasure()
       m = m->nextMeasure();
       if (m) {
             int rtick = m->tick() - note->chord()->tick();
-            seek(playPos.key() + rtick);
+            seek(playPos->tick() + rtick);
             }
       }
 
@@ -1097,13 +1105,13 @@ void Seq::nextMeasure()
 
 void Seq::nextChord()
       {
-      int tick = playPos.key();
+      int tick = playPos->tick();
       for (EventMap::const_iterator i = playPos; i != events.constEnd(); ++i) {
-            if (i.value().type() != ME_NOTEON)
+            if (i->type() != ME_NOTEON)
                   continue;
-            const Event& n = i.value();
-            if (i.key() > tick && n.velo()) {
-                  seek(i.key());
+            const PlayEvent& n = *i;
+            if (i->tick() > tick && n.velo()) {
+                  seek(i->tick());
                   break;
                   }
             }
@@ -1118,8 +1126,8 @@ void Seq::prevMeasure()
       EventMap::const_iterator i = playPos;
       const Note* note = 0;
       for (;;) {
-            if (i.value().type() == ME_NOTEON) {
-                  note = i.value().note();
+            if (i->type() == ME_NOTEON) {
+                  note = i->note();
                   break;
                   }
             if (i == events.begin())
@@ -1133,7 +1141,7 @@ void Seq::prevMeasure()
 
       if (m) {
             int rtick = note->chord()->tick() - m->tick();
-            seek(playPos.key() - rtick);
+            seek(playPos->tick() - rtick);
             }
       else
             seek(0);
@@ -1145,14 +1153,14 @@ void Seq::prevMeasure()
 
 void Seq::prevChord()
       {
-      int tick  = playPos.key();
+      int tick  = playPos->tick();
       //find the chord just before playpos
       EventMap::const_iterator i = playPos;
       for (;;) {
-            if (i.value().type() == ME_NOTEON) {
-                  const Event& n = i.value();
-                  if (i.key() < tick && n.velo()) {
-                        tick = i.key();
+            if (i->type() == ME_NOTEON) {
+                  const PlayEvent& n = *i;
+                  if (i->tick() < tick && n.velo()) {
+                        tick = i->tick();
                         break;
                         }
                   }
@@ -1164,10 +1172,10 @@ void Seq::prevChord()
       if (i != events.constBegin()) {
             i = playPos;
             for (;;) {
-                  if (i.value().type() == ME_NOTEON) {
-                        const Event& n = i.value();
-                        if (i.key() < tick && n.velo()) {
-                              seek(i.key());
+                  if (i->type() == ME_NOTEON) {
+                        const PlayEvent& n = *i;
+                        if (i->tick() < tick && n.velo()) {
+                              seek(i->tick());
                               break;
                               }
                         }
@@ -1298,7 +1306,7 @@ float Seq::gain() const
 //   putEvent
 //---------------------------------------------------------
 
-void Seq::putEvent(const Event& event)
+void Seq::putEvent(const PlayEvent& event)
       {
       if (!cs)
             return;
@@ -1350,11 +1358,11 @@ void Seq::heartBeat()
 
       for (;;) {
             EventMap::const_iterator p = guiPos + 1;
-            if ((p == events.constEnd()) || (p.key() >= playPos.key()))
+            if ((p == events.constEnd()) || (p->tick() >= playPos->tick()))
                   break;
             guiPos = p;
-            if (guiPos.value().type() == ME_NOTEON) {
-                  Event n = guiPos.value();
+            if (guiPos->type() == ME_NOTEON) {
+                  const PlayEvent& n = *guiPos;
                   const Note* note1 = n.note();
                   if (n.velo()) {
                         while (note1) {
@@ -1376,7 +1384,7 @@ void Seq::heartBeat()
                   }
             }
 
-      int utick = guiPos.key();
+      int utick = guiPos->tick();
       int tick = cs->repeatList()->utick2tick(utick);
       mscore->currentScoreView()->moveCursor(tick);
       mscore->setPos(tick);
@@ -118,7 +118,7 @@ class Seq : public QObject, public Sequencer {
       void stopTransport();
       void startTransport();
       void setPos(int);
-      void playEvent(const Event&);
+      void playEvent(const PlayEvent&);
       void guiToSeq(const SeqMsg& msg);
       void metronome(unsigned n, float* l);
 
@@ -189,7 +189,7 @@ class Seq : public QObject, public Sequencer {
 
       int synthNameToIndex(const QString&) const;
       QString synthIndexToName(int) const;
-      void putEvent(const Event&);
+      void putEvent(const PlayEvent&);
       void startNoteTimer(int duration);
       void startNote(int channel, int, int, double nt);
       void eventToGui(Event);
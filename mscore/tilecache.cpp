@@ -0,0 +1,203 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2012 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "tilecache.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+
+static const int TILE_SIZE = 256;         // tile width and height in pixel
+
+//---------------------------------------------------------
+//   rasterize
+//    runs in the thread pool; the picture holds a copy of
+//    all paint commands, the score is not accessed
+//---------------------------------------------------------
+
+static QImage rasterize(QPicture picture, QPointF origin, qreal scale, bool antialias)
+      {
+      QImage image(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+      image.fill(0);
+      QPainter p(&image);
+      p.setRenderHint(QPainter::Antialiasing, antialias);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(scale, scale);
+      p.translate(-origin);
+      p.drawPicture(0, 0, picture);
+      p.end();
+      return image;
+      }
+
+//---------------------------------------------------------
+//   TileCache
+//---------------------------------------------------------
+
+TileCache::TileCache(int maxTiles, QObject* parent)
+   : QObject(parent)
+      {
+      tiles.setMaxCost(maxTiles);
+      _scale     = 0.0;
+      _antialias = false;
+      }
+
+//---------------------------------------------------------
+//   clear
+//    running jobs are left alone, their result is
+//    dropped when they finish
+//---------------------------------------------------------
+
+void TileCache::clear()
+      {
+      tiles.clear();
+      pending.clear();
+      }
+
+//---------------------------------------------------------
+//   invalidate
+//    mark all tiles intersecting the canvas rectangle r
+//    as outdated; they are shown until their new image
+//    is ready
+//---------------------------------------------------------
+
+void TileCache::invalidate(Score* score, const QRectF& r)
+      {
+      if (!score || r.isEmpty() || _scale == 0.0)
+            return;
+      qreal s = TILE_SIZE / _scale;
+      foreach (Page* page, score->pages()) {
+            QRectF pr(r.translated(-page->pos()));
+            if (score->layoutMode() != LayoutLine)
+                  pr &= page->bbox();
+            if (pr.isEmpty())
+                  continue;
+            int x1 = int(floor(pr.left() / s));
+            int x2 = int(floor(pr.right() / s));
+            int y1 = int(floor(pr.top() / s));
+            int y2 = int(floor(pr.bottom() / s));
+            for (int y = y1; y <= y2; ++y) {
+                  for (int x = x1; x <= x2; ++x) {
+                        TileKey key(page->no(), x, y);
+                        Tile* tile = tiles.object(key);
+                        if (tile)
+                              tile->generation = 0;
+                        pending.remove(key);
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   draw
+//    paint the canvas rectangle r of page with the world
+//    transformation of p. Missing or outdated tiles are
+//    recorded with func and queued for rendering; until
+//    then the outdated image is shown, or the recording
+//    is painted directly if there is no image yet.
+//---------------------------------------------------------
+
+void TileCache::draw(QPainter& p, Page* page, const QRectF& r, PaintFunc func, void* data)
+      {
+      QTransform t(p.worldTransform());
+      bool antialias = p.testRenderHint(QPainter::Antialiasing);
+      if (t.m11() != _scale || antialias != _antialias) {
+            clear();
+            _scale     = t.m11();
+            _antialias = antialias;
+            }
+      if (_scale <= 0.0)
+            return;
+
+      QRectF pr(r.translated(-page->pos()));
+      if (pr.isEmpty())
+            return;
+      qreal s = TILE_SIZE / _scale;
+      int x1  = int(floor(pr.left() / s));
+      int x2  = int(floor(pr.right() / s));
+      int y1  = int(floor(pr.top() / s));
+      int y2  = int(floor(pr.bottom() / s));
+
+      // align tiles to device pixels
+      QPointF o(t.map(page->pos()));
+      QPoint origin(lrint(o.x()), lrint(o.y()));
+      int generation = page->generation();
+
+      p.save();
+      p.resetTransform();
+      for (int y = y1; y <= y2; ++y) {
+            for (int x = x1; x <= x2; ++x) {
+                  TileKey key(page->no(), x, y);
+                  QPoint dp(origin + QPoint(x * TILE_SIZE, y * TILE_SIZE));
+                  QRectF tr(x * s, y * s, s, s);
+                  Tile* tile = tiles.object(key);
+                  if (tile)
+                        p.drawImage(dp, tile->image);
+                  if (tile && tile->generation == generation)
+                        continue;
+                  QPicture picture = request(key, generation, page, tr, func, data);
+                  if (!tile) {
+                        p.save();
+                        p.setWorldTransform(t);
+                        p.translate(page->pos());
+                        p.setClipRect(tr);
+                        p.drawPicture(0, 0, picture);
+                        p.restore();
+                        }
+                  }
+            }
+      p.restore();
+      }
+
+//---------------------------------------------------------
+//   request
+//    record the page rectangle tr and render it in the
+//    thread pool unless it is already on its way;
+//    returns the recording
+//---------------------------------------------------------
+
+QPicture TileCache::request(const TileKey& key, int generation, Page* page,
+   const QRectF& tr, PaintFunc func, void* data)
+      {
+      QFutureWatcher<QImage>* w = pending.value(key);
+      if (w && jobs.value(w).generation == generation)
+            return jobs.value(w).picture;
+      QPicture picture;
+      QPainter p(&picture);
+      func(data, p, page, tr);
+      p.end();
+
+      w = new QFutureWatcher<QImage>(this);
+      jobs.insert(w, TileJob(key, generation, tr.translated(page->pos()), picture));
+      pending.insert(key, w);
+      connect(w, SIGNAL(finished()), SLOT(tileFinished()));
+      w->setFuture(QtConcurrent::run(rasterize, picture, tr.topLeft(), _scale, _antialias));
+      return picture;
+      }
+
+//---------------------------------------------------------
+//   tileFinished
+//---------------------------------------------------------
+
+void TileCache::tileFinished()
+      {
+      QFutureWatcher<QImage>* w = static_cast<QFutureWatcher<QImage>*>(sender());
+      TileJob job = jobs.take(w);
+      w->deleteLater();
+      if (pending.value(job.key) != w)      // cleared, invalidated or superseded
+            return;
+      pending.remove(job.key);
+      Tile* tile       = new Tile;
+      tile->image      = w->result();
+      tile->generation = job.generation;
+      tiles.insert(job.key, tile);
+      emit tileReady(job.rect);
+      }
+
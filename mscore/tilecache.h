@@ -0,0 +1,100 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2012 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TILECACHE_H__
+#define __TILECACHE_H__
+
+class Page;
+class Score;
+
+//---------------------------------------------------------
+//   TileKey
+//---------------------------------------------------------
+
+struct TileKey {
+      int page;
+      int x, y;
+
+      TileKey(int p, int tx, int ty) : page(p), x(tx), y(ty) {}
+      bool operator==(const TileKey& k) const { return page == k.page && x == k.x && y == k.y; }
+      };
+
+inline uint qHash(const TileKey& k)
+      {
+      return (uint(k.page) << 20) ^ (uint(k.x) << 10) ^ uint(k.y);
+      }
+
+//---------------------------------------------------------
+//   Tile
+//    rendered square of a page at the current scale
+//---------------------------------------------------------
+
+struct Tile {
+      QImage image;
+      int generation;         // Page::generation() when rendered, 0 if outdated
+      };
+
+//---------------------------------------------------------
+//   TileJob
+//---------------------------------------------------------
+
+struct TileJob {
+      TileKey key;
+      int generation;
+      QRectF rect;            // canvas rectangle of the tile
+      QPicture picture;       // painted while the image is missing
+
+      TileJob() : key(0, 0, 0), generation(0) {}
+      TileJob(const TileKey& k, int g, const QRectF& r, const QPicture& pic)
+         : key(k), generation(g), rect(r), picture(pic) {}
+      };
+
+//---------------------------------------------------------
+//   TileCache
+//    raster cache of page regions for a view. Tiles are
+//    recorded as QPicture in the gui thread and converted
+//    to images by the thread pool. A tile is valid until
+//    the content of its page changes or its region is
+//    invalidated.
+//---------------------------------------------------------
+
+class TileCache : public QObject {
+      Q_OBJECT
+
+   public:
+      typedef void (*PaintFunc)(void* data, QPainter& p, Page* page, const QRectF& r);
+
+   private:
+      QCache<TileKey, Tile> tiles;
+      QHash<TileKey, QFutureWatcher<QImage>*> pending;
+      QHash<QFutureWatcher<QImage>*, TileJob> jobs;
+      qreal _scale;
+      bool _antialias;
+
+      QPicture request(const TileKey&, int generation, Page*, const QRectF& tr, PaintFunc, void* data);
+
+   private slots:
+      void tileFinished();
+
+   signals:
+      void tileReady(const QRectF&);
+
+   public:
+      TileCache(int maxTiles, QObject* parent = 0);
+      void draw(QPainter& p, Page* page, const QRectF& r, PaintFunc func, void* data);
+      void invalidate(Score*, const QRectF&);
+      void clear();
+      };
+
+#endif
+
@@ -113,12 +113,21 @@ void MasterSynth::reset()
 //   play
 //---------------------------------------------------------
 
-void MasterSynth::play(const Event& event, int syntiIdx)
+void MasterSynth::play(const PlayEvent& event, int syntiIdx)
       {
       syntis[syntiIdx]->setActive(true);
       syntis[syntiIdx]->play(event);
       }
 
+//---------------------------------------------------------
+//   prepare
+//---------------------------------------------------------
+
+void MasterSynth::prepare(const PlayEvent& event, int syntiIdx)
+      {
+      syntis[syntiIdx]->prepare(event);
+      }
+
 //---------------------------------------------------------
 //   synthNameToIndex
 //---------------------------------------------------------
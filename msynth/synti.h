@@ -23,6 +23,7 @@
 
 struct MidiPatch;
 class Event;
+class PlayEvent;
 class Synth;
 
 #include "libmscore/sparm.h"
@@ -53,7 +54,10 @@ class Synth {
       virtual QStringList soundFonts() const = 0;
 
       virtual void process(unsigned, float*, float) = 0;
-      virtual void play(const Event&) = 0;
+      virtual void play(const PlayEvent&) = 0;
+      // called outside of the audio thread for controller
+      // events before they are played
+      virtual void prepare(const PlayEvent&) {}
 
       virtual const QList<MidiPatch*>& getPatchInfo() const = 0;
 
@@ -87,7 +91,8 @@ class MasterSynth {
       void init(int sampleRate);
 
       void process(unsigned, float*);
-      void play(const Event&, int);
+      void play(const PlayEvent&, int);
+      void prepare(const PlayEvent&, int);
 
       double gain() const     { return _gain; }
       void setGain(float val) { _gain = val;  }
@@ -0,0 +1,331 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2012 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "fluid/fluid.h"
+#include "fluid/voice.h"
+#include "fluid/sfont.h"
+
+using namespace FluidS;
+
+static const int SAMPLE_RATE  = 44100;
+static const int SAMPLE_LEN   = 100000;
+static const unsigned BLOCK   = 64;
+static const int SECONDS      = 20;       // rendered seconds per measurement
+static const float TOLERANCE  = 32768.0f * 1e-5f;   // max. deviation from the scalar code
+
+//---------------------------------------------------------
+//   TestDsp
+//    micro benchmark of the voice dsp chain:
+//    interpolation, filter, pan and effect sends
+//---------------------------------------------------------
+
+class TestDsp : public QObject
+      {
+      Q_OBJECT
+
+      Sample* sample;
+      float left[BLOCK], right[BLOCK], reverb[BLOCK], chorus[BLOCK];
+
+      void initVoice(Voice*);
+      float render(Voice*, int method, int frames);
+      void benchmark(int method, const char* name);
+      void scalarInterpolate(Voice*, int method, float* buf, int n);
+      void scalarEffects(Voice*, float* buf, int n, float* l, float* r, float* rev, float* cho);
+      void compare(int method, const char* name);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void interpolateNone()      { benchmark(FLUID_INTERP_NONE,     "none");      }
+      void interpolateLinear()    { benchmark(FLUID_INTERP_LINEAR,   "linear");    }
+      void interpolate4thOrder()  { benchmark(FLUID_INTERP_4THORDER, "4th order"); }
+      void interpolate7thOrder()  { benchmark(FLUID_INTERP_7THORDER, "7th order"); }
+      void compareNone()          { compare(FLUID_INTERP_NONE,     "none");      }
+      void compareLinear()        { compare(FLUID_INTERP_LINEAR,   "linear");    }
+      void compare4thOrder()      { compare(FLUID_INTERP_4THORDER, "4th order"); }
+      void compare7thOrder()      { compare(FLUID_INTERP_7THORDER, "7th order"); }
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    create a looped sine wave sample
+//---------------------------------------------------------
+
+void TestDsp::initTestCase()
+      {
+      Voice::dsp_float_config();
+      sample = new Sample(0);
+      sample->data = new short[SAMPLE_LEN];
+      for (int i = 0; i < SAMPLE_LEN; ++i)
+            sample->data[i] = short(sin(i * 2.0 * M_PI / 100.0) * 30000.0);
+      sample->start      = 0;
+      sample->end        = SAMPLE_LEN - 1;
+      sample->loopstart  = 1000;
+      sample->loopend    = SAMPLE_LEN - 1000;
+      sample->samplerate = SAMPLE_RATE;
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestDsp::cleanupTestCase()
+      {
+      delete sample;
+      }
+
+//---------------------------------------------------------
+//   initVoice
+//    setup a looping, slightly detuned and panned voice
+//    with an active low pass filter
+//---------------------------------------------------------
+
+void TestDsp::initVoice(Voice* v)
+      {
+      v->sample     = sample;
+      v->start      = sample->start;
+      v->end        = sample->end;
+      v->loopstart  = sample->loopstart;
+      v->loopend    = sample->loopend;
+      v->gen[GEN_SAMPLEMODE].val = FLUID_LOOP_DURING_RELEASE;
+      v->volenv_section = FLUID_VOICE_ENVSUSTAIN;
+      v->has_looped = false;
+      v->phase.setInt(v->start);
+      v->phase_incr = 1.0594631f;
+      v->amp        = 0.5f;
+      v->amp_incr   = 0.000001f;
+
+      v->a1         = -1.8f;
+      v->a2         = 0.81f;
+      v->b02        = 0.0025f;
+      v->b1         = 0.005f;
+      v->hist1      = 0.0f;
+      v->hist2      = 0.0f;
+      v->filter_coeff_incr_count = 0;
+
+      v->pan        = 100.0f;
+      v->amp_left   = 0.3f;
+      v->amp_right  = 0.7f;
+      v->amp_reverb = 0.2f;
+      v->amp_chorus = 0.1f;
+      }
+
+//---------------------------------------------------------
+//   render
+//    render frames samples, return the peak value
+//---------------------------------------------------------
+
+float TestDsp::render(Voice* v, int method, int frames)
+      {
+      float buf[BLOCK];
+      float peak = 0.0;
+      v->dsp_buf = buf;
+      for (int frame = 0; frame < frames; frame += BLOCK) {
+            memset(left,   0, sizeof(left));
+            memset(right,  0, sizeof(right));
+            memset(reverb, 0, sizeof(reverb));
+            memset(chorus, 0, sizeof(chorus));
+            int count = 0;
+            switch (method) {
+                  case FLUID_INTERP_NONE:
+                        count = v->dsp_float_interpolate_none(BLOCK);
+                        break;
+                  case FLUID_INTERP_LINEAR:
+                        count = v->dsp_float_interpolate_linear(BLOCK);
+                        break;
+                  case FLUID_INTERP_4THORDER:
+                        count = v->dsp_float_interpolate_4th_order(BLOCK);
+                        break;
+                  case FLUID_INTERP_7THORDER:
+                        count = v->dsp_float_interpolate_7th_order(BLOCK);
+                        break;
+                  }
+            v->effects(count, left, right, reverb, chorus);
+            peak = qMax(peak, qAbs(right[0]));
+            }
+      return peak;
+      }
+
+//---------------------------------------------------------
+//   benchmark
+//    report how many voices one core can render in
+//    real time at 44.1 kHz
+//---------------------------------------------------------
+
+void TestDsp::benchmark(int method, const char* name)
+      {
+      Voice voice(0);
+      initVoice(&voice);
+
+      QElapsedTimer timer;
+      timer.start();
+      float peak = render(&voice, method, SECONDS * SAMPLE_RATE);
+      qint64 ms = qMax(timer.elapsed(), qint64(1));
+      qDebug("interpolation %s: %.0f voices per core", name, SECONDS * 1000.0 / ms);
+
+      QVERIFY(peak > 0.0 && peak < 32768.0);
+
+      QBENCHMARK {
+            render(&voice, method, SAMPLE_RATE);
+            }
+      }
+
+//---------------------------------------------------------
+//   scalarInterpolate
+//    reference for the interpolation kernels; plain scalar
+//    code without the sample and loop boundary handling
+//---------------------------------------------------------
+
+void TestDsp::scalarInterpolate(Voice* v, int method, float* buf, int n)
+      {
+      Phase phase = v->phase;
+      Phase incr;
+      incr.setFloat(v->phase_incr);
+      const short* d = v->sample->data;
+      float amp      = v->amp;
+
+      if (method == FLUID_INTERP_7THORDER)
+            phase += (Phase)0x80000000;
+      for (int i = 0; i < n; ++i) {
+            int row = fluid_phase_fract_to_tablerow(phase);
+            int k   = phase.index();
+            float s = 0.0;
+            switch (method) {
+                  case FLUID_INTERP_NONE:
+                        s = d[phase.index_round()];
+                        break;
+                  case FLUID_INTERP_LINEAR:
+                        {
+                        const float* c = Voice::interp_coeff_linear[row];
+                        s = c[0] * d[k] + c[1] * d[k+1];
+                        }
+                        break;
+                  case FLUID_INTERP_4THORDER:
+                        {
+                        const float* c = Voice::interp_coeff[row];
+                        s = c[0] * d[k-1] + c[1] * d[k] + c[2] * d[k+1] + c[3] * d[k+2];
+                        }
+                        break;
+                  case FLUID_INTERP_7THORDER:
+                        {
+                        const float* c = Voice::sinc_table7[row];
+                        for (int j = 0; j < 7; ++j)
+                              s += c[j] * d[k - 3 + j];
+                        }
+                        break;
+                  }
+            buf[i] = amp * s;
+            phase += incr;
+            amp   += v->amp_incr;
+            }
+      if (method == FLUID_INTERP_7THORDER)
+            phase -= (Phase)0x80000000;
+      v->phase = phase;
+      v->amp   = amp;
+      }
+
+//---------------------------------------------------------
+//   scalarEffects
+//    reference for Voice::effects() with constant filter
+//    coefficients and a panned voice
+//---------------------------------------------------------
+
+void TestDsp::scalarEffects(Voice* v, float* buf, int n, float* l, float* r, float* rev, float* cho)
+      {
+      for (int i = 0; i < n; ++i) {
+            float c  = buf[i] - v->a1 * v->hist1 - v->a2 * v->hist2;
+            buf[i]   = v->b02 * (c + v->hist2) + v->b1 * v->hist1;
+            v->hist2 = v->hist1;
+            v->hist1 = c;
+            l[i]   += v->amp_left   * buf[i];
+            r[i]   += v->amp_right  * buf[i];
+            rev[i] += v->amp_reverb * buf[i];
+            cho[i] += v->amp_chorus * buf[i];
+            }
+      }
+
+//---------------------------------------------------------
+//   compare
+//    the dsp chain must match the scalar reference within
+//    TOLERANCE; reports the time of both
+//---------------------------------------------------------
+
+void TestDsp::compare(int method, const char* name)
+      {
+      Voice voice(0);
+      Voice ref(0);
+      initVoice(&voice);
+      initVoice(&ref);
+      // stay clear of the sample start and the loop end
+      voice.phase.setInt(1000);
+      ref.phase.setInt(1000);
+
+      float buf[BLOCK], rbuf[BLOCK];
+      float rl[BLOCK], rr[BLOCK], rrev[BLOCK], rcho[BLOCK];
+      voice.dsp_buf = buf;
+      qint64 kernelTime = 0;
+      qint64 scalarTime = 0;
+      float maxDiff     = 0.0;
+      QElapsedTimer timer;
+
+      for (int frame = 0; frame < SAMPLE_RATE; frame += BLOCK) {
+            memset(left,   0, sizeof(left));
+            memset(right,  0, sizeof(right));
+            memset(reverb, 0, sizeof(reverb));
+            memset(chorus, 0, sizeof(chorus));
+            memset(rl,     0, sizeof(rl));
+            memset(rr,     0, sizeof(rr));
+            memset(rrev,   0, sizeof(rrev));
+            memset(rcho,   0, sizeof(rcho));
+
+            timer.start();
+            int count = 0;
+            switch (method) {
+                  case FLUID_INTERP_NONE:
+                        count = voice.dsp_float_interpolate_none(BLOCK);
+                        break;
+                  case FLUID_INTERP_LINEAR:
+                        count = voice.dsp_float_interpolate_linear(BLOCK);
+                        break;
+                  case FLUID_INTERP_4THORDER:
+                        count = voice.dsp_float_interpolate_4th_order(BLOCK);
+                        break;
+                  case FLUID_INTERP_7THORDER:
+                        count = voice.dsp_float_interpolate_7th_order(BLOCK);
+                        break;
+                  }
+            voice.effects(count, left, right, reverb, chorus);
+            kernelTime += timer.nsecsElapsed();
+
+            timer.start();
+            scalarInterpolate(&ref, method, rbuf, BLOCK);
+            scalarEffects(&ref, rbuf, BLOCK, rl, rr, rrev, rcho);
+            scalarTime += timer.nsecsElapsed();
+
+            QCOMPARE(count, int(BLOCK));
+            for (unsigned i = 0; i < BLOCK; ++i) {
+                  maxDiff = qMax(maxDiff, qAbs(left[i]   - rl[i]));
+                  maxDiff = qMax(maxDiff, qAbs(right[i]  - rr[i]));
+                  maxDiff = qMax(maxDiff, qAbs(reverb[i] - rrev[i]));
+                  maxDiff = qMax(maxDiff, qAbs(chorus[i] - rcho[i]));
+                  }
+            }
+      qDebug("interpolation %s: scalar %lld us, kernels %lld us, max. deviation %g",
+         name, scalarTime / 1000, kernelTime / 1000, maxDiff);
+      QVERIFY(maxDiff <= TOLERANCE);
+      }
+
+QTEST_MAIN(TestDsp)
+
+#include "tst_dsp.moc"
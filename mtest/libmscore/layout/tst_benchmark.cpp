@@ -14,6 +14,12 @@
 #include <QtTest/QtTest>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
 
 #define DIR QString("libmscore/layout/")
 
@@ -33,6 +39,7 @@ class TestBenchmark : public QObject, public MTest
       void benchmark3();
       void benchmark1();
       void benchmark2();
+      void relayout();
       };
 
 //---------------------------------------------------------
@@ -75,6 +82,71 @@ void TestBenchmark::benchmark2()
             }
       }
 
+//---------------------------------------------------------
+//   layoutSnapshot
+//    dump position and size of all pages, systems,
+//    measures and segments
+//---------------------------------------------------------
+
+static QStringList layoutSnapshot(Score* score)
+      {
+      QStringList sl;
+      foreach (Page* page, score->pages()) {
+            sl.append(QString("page %1 %2 %3").arg(page->no())
+               .arg(page->pos().x(), 0, 'f', 2).arg(page->pos().y(), 0, 'f', 2));
+            foreach (System* system, *page->systems()) {
+                  sl.append(QString(" system %1 %2 %3 %4")
+                     .arg(system->pos().x(), 0, 'f', 2).arg(system->pos().y(), 0, 'f', 2)
+                     .arg(system->width(), 0, 'f', 2).arg(system->height(), 0, 'f', 2));
+                  foreach (MeasureBase* mb, system->measures()) {
+                        sl.append(QString("  measure %1 %2 %3").arg(mb->tick())
+                           .arg(mb->pos().x(), 0, 'f', 2).arg(mb->width(), 0, 'f', 2));
+                        if (mb->type() != Element::MEASURE)
+                              continue;
+                        Measure* m = static_cast<Measure*>(mb);
+                        for (Segment* s = m->first(); s; s = s->next())
+                              sl.append(QString("   segment %1 %2").arg(s->tick()).arg(s->pos().x(), 0, 'f', 2));
+                        }
+                  }
+            }
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   relayout
+//    a pitch change only relayouts the system of the
+//    changed measure; it must give the same result as a
+//    full layout
+//---------------------------------------------------------
+
+void TestBenchmark::relayout()
+      {
+      score = readScore(DIR + "goldberg.mscx");
+      score->doLayout();
+
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < 10 && m->nextMeasure(); ++i)
+            m = m->nextMeasure();
+      Chord* chord = 0;
+      for (Segment* s = m->first(Segment::SegChordRest); s; s = s->next(Segment::SegChordRest)) {
+            if (s->element(0) && s->element(0)->type() == Element::CHORD) {
+                  chord = static_cast<Chord*>(s->element(0));
+                  break;
+                  }
+            }
+      QVERIFY(chord);
+
+      score->select(chord->upNote(), SELECT_SINGLE, 0);
+      score->startCmd();
+      score->upDown(true, UP_DOWN_CHROMATIC);
+      QVERIFY(!score->layoutAll());
+      score->endCmd();
+      QStringList l1 = layoutSnapshot(score);
+
+      score->doLayout();
+      QStringList l2 = layoutSnapshot(score);
+      QCOMPARE(l1, l2);
+      }
 
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
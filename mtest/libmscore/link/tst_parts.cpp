@@ -52,6 +52,7 @@ class TestParts : public QObject, public MTest
       void initTestCase();
       void createPart1();
       void createPart2();
+      void createPartsConcurrent();
 
       void createPartBreath();
       void addBreath();
@@ -210,6 +211,38 @@ void TestParts::createPart2()
       testPartCreation("part2");
       }
 
+//---------------------------------------------------------
+//   createPartsConcurrent
+//    createExcerpts() lays out the parts on the thread
+//    pool; the result must not differ from createParts()
+//---------------------------------------------------------
+
+void TestParts::createPartsConcurrent()
+      {
+      Score* score = readScore(DIR + "part2.mscx");
+      QVERIFY(score);
+      score->doLayout();
+
+      QList<Excerpt*> excerpts;
+      for (int i = 0; i < 2; ++i) {
+            Excerpt* e = new Excerpt(0);
+            e->parts().append(score->parts().at(i));
+            e->setTitle(score->parts().at(i)->partName());
+            excerpts.append(e);
+            }
+      ::createExcerpts(excerpts);
+      foreach(Excerpt* e, excerpts) {
+            Score* nscore = e->score();
+            QVERIFY(nscore);
+            nscore->setParentScore(score);
+            score->undo(new AddExcerpt(nscore));
+            nscore->style()->set(ST_createMultiMeasureRests, true);
+            delete e;
+            }
+      QVERIFY(saveCompareScore(score, "part2-7.mscx", DIR + "part2-2o.mscx"));
+      delete score;
+      }
+
 void TestParts::createPartBreath()
       {
       testPartCreation("part3");
@@ -22,6 +22,8 @@
 #include "libmscore/note.h"
 #include "libmscore/keysig.h"
 #include "libmscore/exportmidi.h"
+#include "libmscore/event.h"
+#include "libmscore/system.h"
 
 #include "mtest/mcursor.h"
 #include "mtest/testutils.h"
@@ -41,6 +43,7 @@ class TestMidi : public QObject, public MTest
       void midi1();
       void midi2();
       void midi3();
+      void renderCache();
       };
 
 //---------------------------------------------------------
@@ -281,6 +284,50 @@ void TestMidi::midi3()
       delete score2;
       }
 
+//---------------------------------------------------------
+//   renderCache
+//    transpose several measures of one system; the cached
+//    measure events must give the same result as a cold
+//    render
+//---------------------------------------------------------
+
+void TestMidi::renderCache()
+      {
+      Score* score = readScore("libmscore/layout/goldberg.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      EventMap warm;
+      score->renderMidi(&warm);
+
+      Measure* m1 = score->firstMeasure();
+      while (m1 && (m1->system() == 0 || m1->system()->measures().size() < 4))
+            m1 = m1->nextMeasure();
+      QVERIFY(m1);
+      Measure* m2 = static_cast<Measure*>(m1->system()->measures().back());
+      score->select(m1, SELECT_RANGE, 0);
+      score->select(m2, SELECT_RANGE, 0);
+      score->startCmd();
+      score->upDown(true, UP_DOWN_CHROMATIC);
+      score->endCmd();
+
+      EventMap hot;
+      score->renderMidi(&hot);
+      score->setPlaybackDirty();
+      EventMap cold;
+      score->renderMidi(&cold);
+
+      QCOMPARE(hot.size(), cold.size());
+      EventMap::const_iterator i2 = cold.begin();
+      for (EventMap::const_iterator i1 = hot.begin(); i1 != hot.end(); ++i1, ++i2) {
+            QCOMPARE(i1->tick(), i2->tick());
+            QCOMPARE(i1->type(), i2->type());
+            QCOMPARE(i1->channel(), i2->channel());
+            QCOMPARE(i1->dataA(), i2->dataA());
+            QCOMPARE(i1->dataB(), i2->dataB());
+            }
+      delete score;
+      }
+
 QTEST_MAIN(TestMidi)
 
 #include "tst_midi.moc"
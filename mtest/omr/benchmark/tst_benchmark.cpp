@@ -0,0 +1,113 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//  $Id:$
+//
+//  Copyright (C) 2012 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "omr/omr.h"
+#include "omr/omrpage.h"
+
+#define DIR QString("omr/notes/")
+
+//---------------------------------------------------------
+//   TestBenchmark
+//    timing of the omr pipeline: pdf rasterization,
+//    deskew, staff and bar line recognition
+//---------------------------------------------------------
+
+class TestBenchmark : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QString pdf;
+
+   private slots:
+      void initTestCase();
+      void readPdf();
+      void deskew();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    render a test score to pdf
+//---------------------------------------------------------
+
+void TestBenchmark::initTestCase()
+      {
+      initMTest();
+      Score* score = readScore(DIR + "notes1.mscx");
+      QVERIFY(score);
+      score->doLayout();
+      pdf = "benchmark.pdf";
+      QVERIFY(savePdf(score, pdf));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   readPdf
+//    the whole pipeline
+//---------------------------------------------------------
+
+void TestBenchmark::readPdf()
+      {
+      Omr omr(pdf, 0);
+      QElapsedTimer timer;
+      timer.start();
+      QVERIFY(omr.readPdf());
+      qint64 ms = timer.elapsed();
+      QVERIFY(omr.numPages() > 0);
+      QVERIFY(omr.page(0)->systems().size() > 0);
+      qDebug("omr: %d pages in %lld ms, %.1f ms per page",
+         omr.numPages(), ms, double(ms) / omr.numPages());
+
+      QBENCHMARK {
+            Omr o(pdf, 0);
+            o.readPdf();
+            }
+      }
+
+//---------------------------------------------------------
+//   deskew
+//    recognize a page rotated by 1.5 degrees; deskew
+//    has to rotate it back by -1.5 degrees
+//---------------------------------------------------------
+
+void TestBenchmark::deskew()
+      {
+      Omr omr(pdf, 0);
+      QVERIFY(omr.readPdf());
+      const QImage& image = omr.page(0)->image();
+
+      QImage src = image.convertToFormat(QImage::Format_RGB32);
+      QImage dst(src.size(), QImage::Format_RGB32);
+      dst.fill(0xffffffff);
+      QPainter p(&dst);
+      p.translate(src.width() * .5, src.height() * .5);
+      p.rotate(1.5);
+      p.translate(-src.width() * .5, -src.height() * .5);
+      p.drawImage(0, 0, src);
+      p.end();
+      QImage rotated = dst.convertToFormat(QImage::Format_MonoLSB, image.colorTable(), Qt::ThresholdDither);
+
+      QElapsedTimer timer;
+      timer.start();
+      OmrPage page(&omr);
+      page.setImage(rotated);
+      page.read(0);
+      qDebug("omr: rotated %d x %d page in %lld ms, skew %.2f, %d systems",
+         rotated.width(), rotated.height(), timer.elapsed(), page.skew(), page.systems().size());
+      QVERIFY(qAbs(page.skew() + 1.5) < 0.2);
+      }
+
+QTEST_MAIN(TestBenchmark)
+#include "tst_benchmark.moc"
@@ -142,37 +142,70 @@ bool Omr::readPdf()
             return false;
             }
 
+      //
+      // the mupdf context is not thread safe: pages are
+      // rasterized one by one here while the pages already
+      // rasterized are recognized on the thread pool. Only
+      // one page per pool thread is in flight.
+      //
+      int maxPages = qMax(QThreadPool::globalInstance()->maxThreadCount(), 1);
+      QList<QFuture<void> > inFlight;
       int n = _doc->numPages();
       for (int i = 0; i < n; ++i) {
             OmrPage* page = new OmrPage(this);
             QImage image = _doc->page(i);
             page->setImage(image);
             _pages.append(page);
+            if (inFlight.size() >= maxPages)
+                  inFlight.takeFirst().waitForFinished();
+            inFlight.append(QtConcurrent::run(page, &OmrPage::read, i));
             }
-      process();
+      foreach(QFuture<void> f, inFlight)
+            f.waitForFinished();
+      pageStatistics();
       return true;
       }
 
 //---------------------------------------------------------
 //   process
+//    recognize all pages in parallel
 //---------------------------------------------------------
 
 void Omr::process()
+      {
+      QList<QFuture<void> > pages;
+      int n = _pages.size();
+      for (int i = 0; i < n; ++i)
+            pages.append(QtConcurrent::run(_pages[i], &OmrPage::read, i));
+      foreach(QFuture<void> f, pages)
+            f.waitForFinished();
+      pageStatistics();
+      }
+
+//---------------------------------------------------------
+//   pageStatistics
+//    compute spatium and resolution from the
+//    recognized pages, in page order
+//---------------------------------------------------------
+
+void Omr::pageStatistics()
       {
       double sp = 0;
       double w  = 0;
 
       int pages = 0;
       int n = _pages.size();
+      if (n == 0)
+            return;
       for (int i = 0; i < n; ++i) {
-            _pages[i]->read(i);
             if (_pages[i]->systems().size() > 0) {
                   sp += _pages[i]->spatium();
                   ++pages;
                   }
             w  += _pages[i]->width();
             }
-      _spatium = sp / pages;
+      if (pages)
+            _spatium = sp / pages;
       w       /= n;
       _dpmm    = w / 210.0;            // PaperSize A4
 
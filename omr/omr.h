@@ -49,6 +49,7 @@ class Omr {
       static void initUtils();
 
       void process1(int page);
+      void pageStatistics();
 
    public:
       Omr(Score*);
@@ -55,6 +55,7 @@ struct Lv {
 OmrPage::OmrPage(Omr* parent)
       {
       _omr = parent;
+      _skew = 0.0;
       cropL = cropR = cropT = cropB = 0;
       }
 
@@ -100,8 +101,7 @@ void OmrPage::read(int /*pageNo*/)
       //    search bar lines
       //--------------------------------------------------
 
-      QFuture<void> bl = QtConcurrent::map(_systems, &OmrSystem::searchBarLines);
-      bl.waitForFinished();
+      QtConcurrent::blockingMap(_systems, &OmrSystem::searchBarLines);
       }
 
 //---------------------------------------------------------
@@ -456,6 +456,7 @@ void OmrPage::slice()
 
 //---------------------------------------------------------
 //    deSkew
+//    the page skew is the median of the slice skews
 //---------------------------------------------------------
 
 void OmrPage::deSkew()
@@ -465,8 +466,10 @@ void OmrPage::deSkew()
       uint* db  = new uint[wl * h];
       memset(db, 0, wl * h * sizeof(uint));
 
+      QList<double> angles;
       foreach(const QRect& r, _slices) {
             double rot = skew(r);
+            angles.append(rot);
             if (qAbs(rot) < 0.1) {
                   memcpy(db + wl * r.y(), scanLine(r.y()), wl * r.height() * sizeof(uint));
                   continue;
@@ -517,6 +520,8 @@ void OmrPage::deSkew()
             }
       memcpy(_image.bits(), db, wl * h * sizeof(uint));
       delete[] db;
+      qSort(angles);
+      _skew = angles.isEmpty() ? 0.0 : angles[angles.size() / 2];
       }
 
 struct ScanLine {
@@ -543,11 +548,7 @@ int OmrPage::xproject(const uint* p, int wl)
       int x1 = cropL + w/4;         // only look at part of page
       int x2 = x1 + w/2;
       for (int x = cropL; x < x2; ++x) {
-            uint v = *p++;
-            run += Omr::bitsSetTable[v & 0xff]
-                + Omr::bitsSetTable[(v >> 8) & 0xff]
-                + Omr::bitsSetTable[(v >> 16) & 0xff]
-                + Omr::bitsSetTable[v >> 24];
+            run += popcount(*p++);
             }
       return run;
       }
@@ -781,9 +782,11 @@ void OmrSystem::searchNotes(QList<OmrNote*>* noteList, Pattern* pattern,
       int xx1    = -1000;
       double val = 0.0;
 
+      QVarLengthArray<double, 2048> scores(qMax(x2 - x1, 0));
+      pattern->matchRow(_page->image(), x1, x2, y, scores.data());
+
       for (int x = x1; x < x2; ++x) {
-            Pattern p(&_page->image(), x, y - hh/2, hw, hh);
-            double val1 = p.match(pattern);
+            double val1 = scores[x - x1];
             if (x > (xx1 + hw)) {
                   if (xx1 >= 0)
                         notePeaks.append(Peak(xx1, val));
@@ -99,6 +99,7 @@ class OmrPage {
       Omr* _omr;
       QImage _image;
       double _spatium;
+      double _skew;           // detected rotation in degree
 
       int cropL, cropR;       // crop values in words (32 bit) units
       int cropT, cropB;       // crop values in pixel units
@@ -117,7 +118,6 @@ class OmrPage {
       void getStaffLines();
       double xproject2(int y);
       int xproject(const uint* p, int wl);
-      void radonTransform(ulong* projection, int w, int n, const QRect&);
 
    public:
       OmrPage(Omr* _parent);
@@ -136,6 +136,7 @@ class OmrPage {
 
       const QList<QRect>& slices() const { return _slices;  }
       double spatium() const             { return _spatium; }
+      double skew() const                { return _skew;    }
       double staffDistance() const;
       double systemDistance() const;
       void readHeader(Score* score);
@@ -61,6 +61,77 @@ double Pattern::match(const Pattern* a) const
       return 1.0 - (double(k) / (h() * w()));
       }
 
+//---------------------------------------------------------
+//   imageWord
+//    32 pixel of an image row, zero outside of the image
+//---------------------------------------------------------
+
+static inline uint imageWord(const uint* row, int i, int n)
+      {
+      return (i >= 0 && i < n) ? row[i] : 0;
+      }
+
+//---------------------------------------------------------
+//   matchRow
+//    match the pattern against img at all positions
+//    x1 <= x < x2, vertically centered on y.
+//    scores[x - x1] gets the value match() returns for a
+//    copy of that image area, but the packed image is
+//    compared word by word in place without any copies.
+//---------------------------------------------------------
+
+void Pattern::matchRow(const QImage& img, int x1, int x2, int y, double* scores) const
+      {
+      int n = x2 - x1;
+      if (n <= 0)
+            return;
+      int pw          = w();
+      int ph          = h();
+      int words       = (pw + 31) / 32;
+      uint lastMask   = (pw % 32) ? ~(0xffffffff << (pw % 32)) : 0xffffffff;
+      int imageWords  = img.bytesPerLine() / 4;
+      int y0          = y - ph / 2;
+
+      QVarLengthArray<int, 2048> k(n);
+      memset(k.data(), 0, n * sizeof(int));
+
+      for (int r = 0; r < ph; ++r) {
+            const uint* pr = (const uint*)_image.scanLine(r);
+            int iy = y0 + r;
+            if (iy < 0 || iy >= img.height()) {
+                  // every pattern pixel set is a mismatch
+                  int bits = 0;
+                  for (int j = 0; j < words; ++j)
+                        bits += popcount(pr[j]);
+                  for (int i = 0; i < n; ++i)
+                        k[i] += bits;
+                  continue;
+                  }
+            const uint* ir = (const uint*)img.scanLine(iy);
+            for (int i = 0; i < n; ++i) {
+                  int x    = x1 + i;
+                  int wi   = x >> 5;
+                  int s    = x & 31;
+                  int bits = 0;
+                  for (int j = 0; j < words; ++j) {
+                        quint64 v = imageWord(ir, wi + j, imageWords)
+                           | (quint64(imageWord(ir, wi + j + 1, imageWords)) << 32);
+                        uint iw = uint(v >> s);
+                        if (j == words - 1)
+                              iw &= lastMask;
+                        bits += popcount(iw ^ pr[j]);
+                        }
+                  k[i] += bits;
+                  }
+            }
+      // same overscan correction as match(), the note
+      // search thresholds are tuned for it
+      int overscan = (_image.bytesPerLine() * 8 - pw) * ph;
+      double area  = double(ph * pw);
+      for (int i = 0; i < n; ++i)
+            scores[i] = 1.0 - (double(k[i] - overscan) / area);
+      }
+
 //---------------------------------------------------------
 //   Pattern
 //    create a Pattern from symbol
@@ -63,47 +63,51 @@ class RadonInfo {
       int size;
 
    public:
-      ushort* cells;
+      uint* cells;
       int width, height;
 
       RadonInfo(ulong w, ulong h) {
             width  = w;
             height = h;
             size   = w * h;
-            cells  = new ushort[size];
+            cells  = new uint[size];
             }
       ~RadonInfo() { delete[] cells; }
       void reset() { memset(cells, 0, size * sizeof(*cells)); }
-      ushort getCell(int x, int y) const         { return cells[height * x + y];  }
-      void   setCell(int x, int y, ushort value) { cells[height * x + y] = value; }
+      uint* column(int x)             { return cells + height * x; }
+      const uint* column(int x) const { return cells + height * x; }
       };
 
 //---------------------------------------------------------
 //   radonProjection
+//    the inner loops run over contiguous columns without
+//    aliasing so the compiler can vectorize them
 //---------------------------------------------------------
 
 static void radonProjection(RadonInfo* src, RadonInfo* dst, int sign, ulong* projection)
       {
       RadonInfo* p = src;
       RadonInfo* q = dst;
+      int h = p->height;
       for (int step = 1; step < p->width; step *= 2) {
             for (int x = 0; x < p->width; x += 2 * step) {
                   for (int i = 0; i < step; i++) {
+                        const uint* s1 = p->column(x + i);
+                        const uint* s2 = p->column(x + i + step) + i;
+                        uint* d1       = q->column(x + 2 * i);
+                        uint* d2       = q->column(x + 2 * i + 1);
                         int y;
-                        for (y = 0; y < (p->height-i-1); y++) {
-                              ushort cell = p->getCell(x+i, y);
-                              q->setCell(x+2*i,   y, cell + p->getCell(x+i+step, y+i));
-                              q->setCell(x+2*i+1, y, cell + p->getCell(x+i+step, y+i+1));
+                        for (y = 0; y < (h-i-1); y++) {
+                              d1[y] = s1[y] + s2[y];
+                              d2[y] = s1[y] + s2[y + 1];
                               }
-                        for ( ; y < (p->height-i); y++) {
-                              ushort cell = p->getCell(x+i, y);
-                              q->setCell(x+2*i, y, cell + p->getCell(x+i+step, y+i));
-                              q->setCell(x+2*i+1, y, cell);
+                        for ( ; y < (h-i); y++) {
+                              d1[y] = s1[y] + s2[y];
+                              d2[y] = s1[y];
                               }
-                        for ( ; y < p->height; y++) {
-                              ushort cell = p->getCell(x+i, y);
-                              q->setCell(x+2*i, y, cell);
-                              q->setCell(x+2*i+1, y, cell);
+                        for ( ; y < h; y++) {
+                              d1[y] = s1[y];
+                              d2[y] = s1[y];
                               }
                         }
                   }
@@ -112,9 +116,10 @@ static void radonProjection(RadonInfo* src, RadonInfo* dst, int sign, ulong* pro
             q = swap;
             }
       for (int x = 0; x < p->width; x++) {
-            uint sum = 0;
-            for (int y = 0; y < (p->height-1); y++) {
-                  int delta = p->getCell(x, y) - p->getCell(x, y + 1);
+            const uint* c = p->column(x);
+            ulong sum = 0;
+            for (int y = 0; y < (h-1); y++) {
+                  long delta = long(c[y]) - long(c[y + 1]);
                   sum += delta * delta;
                   }
             projection[p->width + sign * x - 1] = sum;
@@ -123,61 +128,120 @@ static void radonProjection(RadonInfo* src, RadonInfo* dst, int sign, ulong* pro
 
 //---------------------------------------------------------
 //   radonTransform
+//    coarse radon transform of a slice; counts holds the
+//    number of pixels set in every word of the slice,
+//    cells combine one word and COARSE_ROWS rows
 //---------------------------------------------------------
 
-void OmrPage::radonTransform(ulong* projection, int w, int n, const QRect& r)
-      {
-      int h = r.height();
-      RadonInfo* src = new RadonInfo(w, h);
-      RadonInfo* dst = new RadonInfo(w, h);
-
-      src->reset();
-      for (int y = 0; y < h; y++) {
-            int i = n;
-            const uchar* p = (const uchar*)scanLine(r.y() + y);
-            for (int x = 0; x < n; ++x)
-                  src->setCell(--i, y, Omr::bitsSetTable[*p++]);
-            }
-      radonProjection(src, dst, -1, projection);
+static const int COARSE_ROWS = 4;
 
-      src->reset();
-      for (int y = 0; y < h; y++) {
-            const uchar* p = (const uchar*)scanLine(r.y() + y);
-            for (int x = 0; x < n; ++x)
-                  src->setCell(x, y, Omr::bitsSetTable[*p++]);
+static void radonTransform(ulong* projection, int w, int wl, int h, const uchar* counts)
+      {
+      int ch = (h + COARSE_ROWS - 1) / COARSE_ROWS;
+      RadonInfo* src = new RadonInfo(w, ch);
+      RadonInfo* dst = new RadonInfo(w, ch);
+
+      for (int sign = -1; sign <= 1; sign += 2) {
+            src->reset();
+            for (int y = 0; y < h; y++) {
+                  const uchar* p = counts + y * wl;
+                  int cy = y / COARSE_ROWS;
+                  for (int x = 0; x < wl; ++x) {
+                        int cx = sign < 0 ? wl - 1 - x : x;
+                        src->column(cx)[cy] += p[x];
+                        }
+                  }
+            radonProjection(src, dst, sign, projection);
             }
-      radonProjection(src, dst, 1, projection);
-
       delete dst;
       delete src;
       }
 
+//---------------------------------------------------------
+//   shearEnergy
+//    sharpness of the row projection of a slice sheared
+//    by skew rows over span pixel: the sum of squared
+//    differences of neighbour rows
+//---------------------------------------------------------
+
+static ulong shearEnergy(int skew, int span, int wl, int h, const uchar* counts)
+      {
+      QVarLengthArray<int, 512> shift(wl);
+      int minShift = 0;
+      int maxShift = 0;
+      for (int x = 0; x < wl; ++x) {
+            shift[x] = lrint(double(x * 32 + 16) * skew / span);
+            minShift = qMin(minShift, shift[x]);
+            maxShift = qMax(maxShift, shift[x]);
+            }
+      int n = h + maxShift - minShift;
+      QVarLengthArray<uint, 4096> profile(n);
+      memset(profile.data(), 0, n * sizeof(uint));
+      for (int y = 0; y < h; ++y) {
+            const uchar* p = counts + y * wl;
+            uint* d = profile.data() + y + maxShift;
+            for (int x = 0; x < wl; ++x)
+                  d[-shift[x]] += p[x];
+            }
+      ulong sum = 0;
+      for (int i = 0; i < n - 1; ++i) {
+            long delta = long(profile[i]) - long(profile[i + 1]);
+            sum += delta * delta;
+            }
+      return sum;
+      }
+
 //---------------------------------------------------------
 //   skew
 //    compute image skew angle
+//    A radon transform on a bitmap reduced to one cell per
+//    word and COARSE_ROWS rows finds the skew to within
+//    COARSE_ROWS rows over the page width; the candidates
+//    around it are then compared at full row resolution.
 //---------------------------------------------------------
 
 double OmrPage::skew(const QRect& r)
       {
 //      Benchmark bench("imageSkew");
 
-      int nn    = wordsPerLine() * 4;
+      int wl    = wordsPerLine();
+      int h     = r.height();
       int width = 1;
-      for (; width < nn; width <<= 1)
+      for (; width < wl; width <<= 1)
             ;
-      int n = 2 * width - 1;
+      int span = width * 32;
+
+      QVector<uchar> counts(wl * h);
+      uchar* c = counts.data();
+      for (int y = 0; y < h; ++y) {
+            const uint* p = scanLine(r.y() + y);
+            for (int x = 0; x < wl; ++x)
+                  *c++ = popcount(*p++);
+            }
 
+      int n = 2 * width - 1;
       ulong* projection = new ulong[n];
-      radonTransform(projection, width, nn, r);
-      uint max_projection = 0;
-      int skew            = 0;
+      radonTransform(projection, width, wl, h, counts.constData());
+      ulong max_projection = 0;
+      int coarseSkew       = 0;
       for (int i = 0; i < n; i++) {
             if (projection[i] > max_projection) {
-                  skew = i - width + 1;
+                  coarseSkew = i - width + 1;
                   max_projection = projection[i];
                   }
             }
       delete[] projection;
-      return RadiansToDegrees(-atan((double) skew/width/8));
+
+      int skew   = coarseSkew * COARSE_ROWS;
+      ulong best = 0;
+      for (int d = -COARSE_ROWS; d <= COARSE_ROWS; ++d) {
+            int s   = coarseSkew * COARSE_ROWS + d;
+            ulong e = shearEnergy(s, span, wl, h, counts.constData());
+            if (e > best) {
+                  best = e;
+                  skew = s;
+                  }
+            }
+      return RadiansToDegrees(-atan(double(skew) / span));
       }
 
@@ -23,6 +23,22 @@
 
 extern double curTime();
 
+//---------------------------------------------------------
+//   popcount
+//    number of pixels set in a word of a 1 bit image
+//---------------------------------------------------------
+
+inline int popcount(uint v)
+      {
+#ifdef __GNUC__
+      return __builtin_popcount(v);
+#else
+      v = v - ((v >> 1) & 0x55555555);
+      v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+      return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#endif
+      }
+
 //---------------------------------------------------------
 //   Benchmark
 //---------------------------------------------------------